@@ -118,6 +118,12 @@ public class AIVDemo: AUAudioUnit {
         // Init super class
         try super.init(componentDescription: componentDescription, options: options)
 
+        // The host re-reads latency when it is notified of a change
+        parameters.latencyDidChange = { [weak self] in
+            self?.willChangeValue(forKey: "latency")
+            self?.didChangeValue(forKey: "latency")
+        }
+
         // Log component description values
         log(componentDescription)
         
@@ -170,6 +176,12 @@ public class AIVDemo: AUAudioUnit {
         kernelAdapter.deallocateRenderResources()
     }
 
+    /// Oversampling island round trips, limiter lookahead and the pitch
+    /// corrector's grain delay, in seconds.
+    public override var latency: TimeInterval {
+        return kernelAdapter.latency
+    }
+
     public override var internalRenderBlock: AUInternalRenderBlock {
         return kernelAdapter.internalRenderBlock()
     }
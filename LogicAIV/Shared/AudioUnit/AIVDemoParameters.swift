@@ -19,6 +19,9 @@ class AIVDemoParameters {
         case phaseInvert = 36
         case pitchAmount = 2
         case pitchSpeed = 3
+        case pitchKey = 55
+        case pitchScale = 56
+        case pitchNotes = 57
         case eqBand1Freq = 4
         case eqBand1Gain = 5
         case eqBand1Q = 6
@@ -63,6 +66,7 @@ class AIVDemoParameters {
         case limiterCeiling = 60
         case limiterLookahead = 61
         case compAutoMakeup = 62
+        case dynamicsLink = 63
         
         // Enables
         case gateEnable = 70
@@ -74,6 +78,9 @@ class AIVDemoParameters {
         case reverbEnable = 76
         case pitchEnable = 77
         case limiterEnable = 78
+
+        // Quality
+        case oversampling = 80
     }
 
     // Parameters
@@ -87,6 +94,9 @@ class AIVDemoParameters {
     
     var pitchAmountParam: AUParameter!
     var pitchSpeedParam: AUParameter!
+    var pitchKeyParam: AUParameter!
+    var pitchScaleParam: AUParameter!
+    var pitchNotesParam: AUParameter!
     
     // EQ
     var eqBand1FreqParam: AUParameter!
@@ -112,6 +122,7 @@ class AIVDemoParameters {
     // Limiter
     var limiterCeilingParam: AUParameter!
     var limiterLookaheadParam: AUParameter!
+    var dynamicsLinkParam: AUParameter!
     
 
     
@@ -163,6 +174,12 @@ class AIVDemoParameters {
     var pitchEnableParam: AUParameter!
     var limiterEnableParam: AUParameter!
 
+    // Quality
+    var oversamplingParam: AUParameter!
+
+    /// Called when a parameter that changes the reported latency is set.
+    var latencyDidChange: (() -> Void)?
+
     let parameterTree: AUParameterTree
     let kernelAdapter: AIVDSPKernelAdapter
 
@@ -193,6 +210,16 @@ class AIVDemoParameters {
         pitchAmountParam.value = 50.0 // No shift
         
         pitchSpeedParam = AUParameterTree.createParameter(withIdentifier: "pitchSpeed", name: "Pitch Speed", address: AIVParam.pitchSpeed.rawValue, min: 0.0, max: 100.0, unit: .percent, unitName: nil, flags: [.flag_IsReadable, .flag_IsWritable], valueStrings: nil, dependentParameters: nil)
+
+        pitchKeyParam = AUParameterTree.createParameter(withIdentifier: "pitchKey", name: "Pitch Key", address: AIVParam.pitchKey.rawValue, min: 0, max: 11, unit: .indexed, unitName: nil, flags: [.flag_IsReadable, .flag_IsWritable], valueStrings: ["C", "C#", "D", "D#", "E", "F", "F#", "G", "G#", "A", "A#", "B"], dependentParameters: nil)
+        pitchKeyParam.value = 0.0
+
+        pitchScaleParam = AUParameterTree.createParameter(withIdentifier: "pitchScale", name: "Pitch Scale", address: AIVParam.pitchScale.rawValue, min: 0, max: 4, unit: .indexed, unitName: nil, flags: [.flag_IsReadable, .flag_IsWritable], valueStrings: ["Off", "Chromatic", "Major", "Minor", "Custom"], dependentParameters: nil)
+        pitchScaleParam.value = 1.0 // Chromatic
+
+        // Custom scale: bit n enables the note n semitones above the key
+        pitchNotesParam = AUParameterTree.createParameter(withIdentifier: "pitchNotes", name: "Pitch Notes", address: AIVParam.pitchNotes.rawValue, min: 1, max: 4095, unit: .generic, unitName: nil, flags: [.flag_IsReadable, .flag_IsWritable], valueStrings: nil, dependentParameters: nil)
+        pitchNotesParam.value = 4095.0
         
         // EQ
         eqBand1FreqParam = AUParameterTree.createParameter(withIdentifier: "eq1Freq", name: "Low Freq", address: AIVParam.eqBand1Freq.rawValue, min: 20.0, max: 20000.0, unit: .hertz, unitName: nil, flags: [.flag_IsReadable, .flag_IsWritable], valueStrings: nil, dependentParameters: nil)
@@ -243,9 +270,12 @@ class AIVDemoParameters {
         limiterCeilingParam = AUParameterTree.createParameter(withIdentifier: "limiterCeiling", name: "Ceiling", address: AIVParam.limiterCeiling.rawValue, min: -6.0, max: 0.0, unit: .decibels, unitName: nil, flags: [.flag_IsReadable, .flag_IsWritable], valueStrings: nil, dependentParameters: nil)
         limiterCeilingParam.value = -0.1
         
-        limiterLookaheadParam = AUParameterTree.createParameter(withIdentifier: "limiterLookahead", name: "Lookahead", address: AIVParam.limiterLookahead.rawValue, min: 0.1, max: 5.0, unit: .milliseconds, unitName: nil, flags: [.flag_IsReadable, .flag_IsWritable], valueStrings: nil, dependentParameters: nil)
+        limiterLookaheadParam = AUParameterTree.createParameter(withIdentifier: "limiterLookahead", name: "Lookahead", address: AIVParam.limiterLookahead.rawValue, min: 0.1, max: 10.0, unit: .milliseconds, unitName: nil, flags: [.flag_IsReadable, .flag_IsWritable], valueStrings: nil, dependentParameters: nil)
         limiterLookaheadParam.value = 2.0
         
+        // Compressor and limiter gain shared across channels
+        dynamicsLinkParam = AUParameterTree.createParameter(withIdentifier: "dynamicsLink", name: "Link", address: AIVParam.dynamicsLink.rawValue, min: 0.0, max: 1.0, unit: .boolean, unitName: nil, flags: [.flag_IsReadable, .flag_IsWritable], valueStrings: nil, dependentParameters: nil)
+        
 
         
         // Saturation
@@ -347,17 +377,20 @@ class AIVDemoParameters {
         limiterEnableParam = AUParameterTree.createParameter(withIdentifier: "limiterEnable", name: "Limiter Enable", address: AIVParam.limiterEnable.rawValue, min: 0, max: 1, unit: .boolean, unitName: nil, flags: [.flag_IsReadable, .flag_IsWritable], valueStrings: nil, dependentParameters: nil)
         limiterEnableParam.value = 0.0
 
+        // Quality (Default 4x)
+        oversamplingParam = AUParameterTree.createParameter(withIdentifier: "oversampling", name: "Oversampling", address: AIVParam.oversampling.rawValue, min: 0, max: 3, unit: .indexed, unitName: nil, flags: [.flag_IsReadable, .flag_IsWritable], valueStrings: ["1x", "2x", "4x", "8x"], dependentParameters: nil)
+        oversamplingParam.value = 2.0
 
         // 2. Create Parameter Tree
         parameterTree = AUParameterTree.createTree(withChildren: [
             gainParam, bypassParam,
             inputGainParam, saturationParam, phaseInvertParam,
-            pitchAmountParam, pitchSpeedParam,
+            pitchAmountParam, pitchSpeedParam, pitchKeyParam, pitchScaleParam, pitchNotesParam,
             eqBand1FreqParam, eqBand1GainParam, eqBand1QParam,
             eqBand2FreqParam, eqBand2GainParam, eqBand2QParam,
             eqBand3FreqParam, eqBand3GainParam, eqBand3QParam,
             compInputParam, compRatioParam, compAttackParam, compReleaseParam, compMakeupParam, compAutoMakeupParam,
-            limiterCeilingParam, limiterLookaheadParam,
+            limiterCeilingParam, limiterLookaheadParam, dynamicsLinkParam,
 
             satDriveParam, satTypeParam,
             delayTimeParam, delayFeedbackParam, delayMixParam,
@@ -367,12 +400,22 @@ class AIVDemoParameters {
             gateThreshParam, gateRangeParam, gateAttackParam, gateHoldParam, gateReleaseParam, gateHysteresisParam,
             cutoffParam, resonanceParam,
             
-            gateEnableParam, deesserEnableParam, eqEnableParam, compEnableParam, satEnableParam, delayEnableParam, reverbEnableParam, pitchEnableParam, limiterEnableParam
+            gateEnableParam, deesserEnableParam, eqEnableParam, compEnableParam, satEnableParam, delayEnableParam, reverbEnableParam, pitchEnableParam, limiterEnableParam,
+
+            oversamplingParam
         ])
 
         // 3. Connect to Kernel
-        parameterTree.implementorValueObserver = { param, value in
+        parameterTree.implementorValueObserver = { [weak self] param, value in
             kernelAdapter.setParameter(param, value: value)
+
+            switch AIVParam(rawValue: param.address) {
+            case .oversampling, .limiterLookahead, .limiterEnable, .compEnable,
+                 .satEnable, .pitchEnable:
+                self?.latencyDidChange?()
+            default:
+                break
+            }
         }
 
         parameterTree.implementorValueProvider = { param in
@@ -0,0 +1,133 @@
+//
+//  AIVAnalysisWorker.hpp
+//  AIVExtension
+//
+//  Created by AIV on 02/02/2026.
+//
+
+#pragma once
+
+#import <atomic>
+#import <memory>
+#import <thread>
+#import <vector>
+
+#import "AIVDSPClasses.hpp"
+#import "AIVLockFree.hpp"
+
+// --- Analysis Worker ---
+// Runs the CrossNormalizer analysis off the render thread. The render thread
+// copies each input block into a per-pair SPSC ring (wait-free; a block that
+// does not fit is dropped, the analysis is slow-moving) and picks up the
+// newest control snapshot the worker has published, so the controls lag the
+// audio by at least one block. The worker sleeps on a semaphore the render
+// thread signals with each block, so it neither polls nor lags a timer. Heavier analysis can grow here without
+// growing the render thread's cost.
+template <int Lanes> class AnalysisWorker {
+public:
+  ~AnalysisWorker() { stop(); }
+
+  // Not real-time safe: allocates the rings and starts the thread
+  void start(int numPairs, int maxFrames, double sampleRate) {
+    stop();
+    mMaxFrames = maxFrames;
+    mSampleRate = sampleRate;
+    mPairs.clear();
+    for (int pair = 0; pair < numPairs; ++pair) {
+      std::unique_ptr<Pair> p(new Pair);
+      p->audio.allocate((size_t)kBlocksInFlight * Lanes * maxFrames);
+      p->blocks.allocate(kBlocksInFlight);
+      p->scratch.resize((size_t)Lanes * maxFrames);
+      p->normalizer.initialize(sampleRate);
+      mPairs.push_back(std::move(p));
+    }
+    mRunning.store(true, std::memory_order_release);
+    mThread = std::thread([this] { run(); });
+  }
+
+  void stop() {
+    if (!mThread.joinable())
+      return;
+    mRunning.store(false, std::memory_order_release);
+    mWake.signal();
+    mThread.join();
+  }
+
+  // Render thread: queue one block of a pair for analysis
+  void push(int pair, const float *const *inputs, int numInputs,
+            int numFrames, float gateState) {
+    Pair &p = *mPairs[pair];
+    const size_t samples = (size_t)numInputs * numFrames;
+    if (numFrames > mMaxFrames || p.blocks.writeAvailable() == 0 ||
+        p.audio.writeAvailable() < samples)
+      return;
+    for (int c = 0; c < numInputs; ++c)
+      p.audio.write(inputs[c], numFrames);
+    // The header goes last: once it is visible, so is its audio
+    const Block block = {numInputs, numFrames, gateState};
+    p.blocks.write(&block, 1);
+    mWake.signal();
+  }
+
+  // Render thread: newest controls for a pair, or nullptr if none since
+  // the last call
+  const CrossNormalizer::Controls *acquire(int pair) {
+    return mPairs[pair]->controls.acquire();
+  }
+
+private:
+  // Host buffers that may queue up before the worker catches up
+  static constexpr int kBlocksInFlight = 8;
+
+  struct Block {
+    int numChannels;
+    int numFrames;
+    float gateState;
+  };
+
+  struct Pair {
+    SPSCRing<float> audio; // each block's channels, one after the other
+    SPSCRing<Block> blocks;
+    std::vector<float> scratch;
+    CrossNormalizer normalizer;
+    TripleBuffer<CrossNormalizer::Controls> controls;
+  };
+
+  void run() {
+    // The worker's own thread: same floating-point mode as the render thread
+    ScopedNoDenormals noDenormals;
+    while (true) {
+      mWake.wait();
+      if (!mRunning.load(std::memory_order_acquire))
+        return;
+      // One wake may cover several blocks; drain whatever has landed
+      for (auto &p : mPairs) {
+        Block block;
+        bool fresh = false;
+        while (p->blocks.read(&block, 1)) {
+          const float *channels[Lanes];
+          for (int c = 0; c < block.numChannels; ++c) {
+            float *channel = p->scratch.data() + c * block.numFrames;
+            p->audio.read(channel, block.numFrames);
+            channels[c] = channel;
+          }
+          p->normalizer.processLogic(channels, block.numChannels,
+                                     block.numFrames, block.gateState, 0.0f,
+                                     mSampleRate);
+          fresh = true;
+        }
+        if (fresh) {
+          p->controls.back() = p->normalizer.getControls();
+          p->controls.publish();
+        }
+      }
+    }
+  }
+
+  std::vector<std::unique_ptr<Pair>> mPairs;
+  int mMaxFrames = 0;
+  double mSampleRate = 44100.0;
+  std::atomic<bool> mRunning{false};
+  WakeSemaphore mWake;
+  std::thread mThread;
+};
@@ -0,0 +1,376 @@
+//
+//  AIVConvolution.hpp
+//  AIVExtension
+//
+//  Created by AIV on 02/02/2026.
+//
+
+#pragma once
+
+#import <algorithm>
+#import <atomic>
+#import <cmath>
+#import <cstddef>
+#import <memory>
+#import <thread>
+#import <vector>
+
+#import "AIVFFT.hpp"
+#import "AIVLockFree.hpp"
+
+// --- Partitioned Convolver (uniform, overlap-save) ---
+// Convolves one channel with a segment of an impulse response cut into
+// partitions of blockSize samples. Each call takes the last 2 * blockSize
+// input samples, transforms them once into a frequency-domain delay line and
+// multiply-accumulates every partition's spectrum against its delayed input
+// spectrum; one inverse transform yields the next blockSize output samples.
+// Output for the block just completed is one block late, which the caller
+// covers by starting the segment blockSize samples into the response.
+class PartitionedConvolver {
+public:
+  // Not real-time safe: allocates and transforms the partitions
+  void initialize(const float *impulse, int length, int blockSize) {
+    mBlock = blockSize;
+    mPartitions = (std::max(length, 0) + blockSize - 1) / blockSize;
+    mFFT.reset(new RealFFT(2 * blockSize));
+    mBins = mFFT->numBins();
+
+    const size_t spectra = (size_t)mPartitions * mBins;
+    mFilterRe.assign(spectra, 0.0f);
+    mFilterIm.assign(spectra, 0.0f);
+    mInputRe.assign(spectra, 0.0f);
+    mInputIm.assign(spectra, 0.0f);
+    mAccRe.assign(mBins, 0.0f);
+    mAccIm.assign(mBins, 0.0f);
+    mTime.assign(2 * blockSize, 0.0f);
+
+    // Each partition is zero-padded to the transform size
+    for (int p = 0; p < mPartitions; ++p) {
+      const int start = p * blockSize;
+      const int count = std::min(blockSize, length - start);
+      std::fill(mTime.begin(), mTime.end(), 0.0f);
+      std::copy(impulse + start, impulse + start + count, mTime.begin());
+      mFFT->forward(mTime.data(), mFilterRe.data() + p * mBins,
+                    mFilterIm.data() + p * mBins);
+    }
+    mSlot = 0;
+  }
+
+  bool empty() const { return mPartitions == 0; }
+
+  void reset() {
+    std::fill(mInputRe.begin(), mInputRe.end(), 0.0f);
+    std::fill(mInputIm.begin(), mInputIm.end(), 0.0f);
+    mSlot = 0;
+  }
+
+  // window: the last 2 * blockSize input samples, oldest first
+  // output: blockSize samples
+  void process(const float *window, float *output) {
+    if (mPartitions == 0) {
+      std::fill_n(output, mBlock, 0.0f);
+      return;
+    }
+    // Newest input spectrum into the delay line, which runs backwards so
+    // partition p pairs with slot (mSlot + p) % mPartitions
+    mSlot = (mSlot == 0 ? mPartitions : mSlot) - 1;
+    mFFT->forward(window, mInputRe.data() + mSlot * mBins,
+                  mInputIm.data() + mSlot * mBins);
+
+    std::fill(mAccRe.begin(), mAccRe.end(), 0.0f);
+    std::fill(mAccIm.begin(), mAccIm.end(), 0.0f);
+    float *accRe = mAccRe.data();
+    float *accIm = mAccIm.data();
+    for (int p = 0; p < mPartitions; ++p) {
+      int slot = mSlot + p;
+      if (slot >= mPartitions)
+        slot -= mPartitions;
+      const float *hr = mFilterRe.data() + p * mBins;
+      const float *hi = mFilterIm.data() + p * mBins;
+      const float *xr = mInputRe.data() + slot * mBins;
+      const float *xi = mInputIm.data() + slot * mBins;
+      for (int k = 0; k < mBins; ++k) {
+        accRe[k] += hr[k] * xr[k] - hi[k] * xi[k];
+        accIm[k] += hr[k] * xi[k] + hi[k] * xr[k];
+      }
+    }
+
+    // Overlap-save: the first half is circular wrap-around, the second half
+    // is the linear convolution
+    mFFT->inverse(accRe, accIm, mTime.data());
+    std::copy_n(mTime.data() + mBlock, mBlock, output);
+  }
+
+private:
+  std::unique_ptr<RealFFT> mFFT;
+  int mBlock = 0;
+  int mBins = 0;
+  int mPartitions = 0;
+  int mSlot = 0;
+  std::vector<float> mFilterRe, mFilterIm; // per partition, mBins each
+  std::vector<float> mInputRe, mInputIm;   // frequency-domain delay line
+  std::vector<float> mAccRe, mAccIm;
+  std::vector<float> mTime;
+};
+
+// --- Convolution Reverb (stereo, zero latency) ---
+// Convolves each channel with its own impulse response (a mono response is
+// shared) in three segments, so the output has no latency however long the
+// response is:
+//   [0, kHeadBlock)              direct-form FIR, per sample
+//   [kHeadBlock, 3 * kTailBlock) kHeadBlock partitions, on the render thread
+//   [3 * kTailBlock, length)     kTailBlock partitions, on a worker thread
+// The head segment starts one of its blocks later than its partitions'
+// latency. The tail starts three of its blocks in: one to collect the
+// input and two for the worker to convolve it, so the worker always has a
+// full block of slack and the render thread only copies buffers at each
+// tail boundary. The render thread never waits for the worker or runs its
+// job: a result that is not ready when due is dropped and counted as a
+// missed block, like an xrun. The worker runs at raised priority so that
+// ordinary threads cannot hold it past its deadline.
+class ConvolutionReverb {
+public:
+  static constexpr int kHeadBlock = 64;
+  static constexpr int kTailBlock = 1024;
+  // Tail jobs in flight, a power of two
+  static constexpr int kTailJobs = 4;
+
+  // Not real-time safe: transforms the response and starts the worker
+  // when there is a tail. Responses are used at the session rate as given,
+  // scaled to unit energy on the louder channel.
+  ConvolutionReverb(const float *const *impulse, int numChannels, int length) {
+    length = std::max(length, 0);
+    mLength = numChannels > 0 ? length : 0;
+
+    double energy = 0.0;
+    for (int c = 0; c < std::min(numChannels, 2); ++c) {
+      double sum = 0.0;
+      for (int i = 0; i < length; ++i)
+        sum += (double)impulse[c][i] * impulse[c][i];
+      energy = std::max(energy, sum);
+    }
+    const float scale = energy > 0.0 ? (float)(1.0 / std::sqrt(energy)) : 0.0f;
+
+    std::vector<float> response(mLength);
+    for (int c = 0; c < 2; ++c) {
+      Channel &ch = mChannels[c];
+      if (mLength > 0) {
+        const float *source = impulse[std::min(c, numChannels - 1)];
+        for (int i = 0; i < mLength; ++i)
+          response[i] = source[i] * scale;
+      }
+
+      // The direct taps are stored reversed, so each output sample is a
+      // forward dot product over the input window
+      const int direct = std::min(mLength, (int)kHeadBlock);
+      ch.directTaps.assign(kHeadBlock, 0.0f);
+      for (int i = 0; i < direct; ++i)
+        ch.directTaps[kHeadBlock - 1 - i] = response[i];
+
+      const int headEnd = std::min(mLength, 3 * kTailBlock);
+      ch.head.initialize(response.data() + direct, headEnd - direct,
+                         kHeadBlock);
+      ch.headWindow.assign(2 * kHeadBlock, 0.0f);
+      ch.headOut.assign(kHeadBlock, 0.0f);
+
+      ch.tail.initialize(response.data() + headEnd, mLength - headEnd,
+                         kTailBlock);
+      ch.tailIn.assign(kTailBlock, 0.0f);
+      ch.tailOut.assign(kTailBlock, 0.0f);
+      ch.jobIn.assign(kTailJobs * kTailBlock, 0.0f);
+      ch.jobOut.assign(kTailJobs * kTailBlock, 0.0f);
+      ch.tailWindow.assign(2 * kTailBlock, 0.0f);
+    }
+    for (auto &stamp : mJobStamps)
+      stamp.store(kNoJob, std::memory_order_relaxed);
+
+    mHasTail = !mChannels[0].tail.empty();
+    if (mHasTail) {
+      mRunning.store(true, std::memory_order_release);
+      mThread = std::thread([this] { run(); });
+    }
+  }
+
+  ~ConvolutionReverb() {
+    if (!mThread.joinable())
+      return;
+    mRunning.store(false, std::memory_order_release);
+    mWake.signal();
+    mThread.join();
+  }
+
+  ConvolutionReverb(const ConvolutionReverb &) = delete;
+  ConvolutionReverb &operator=(const ConvolutionReverb &) = delete;
+
+  bool empty() const { return mLength == 0; }
+
+  // Samples the response rings on after the input stops
+  int tailSamples() const { return mLength + kTailBlock; }
+
+  // Tail blocks dropped because the worker fell behind; any thread
+  unsigned missedTailBlocks() const {
+    return mMissedBlocks.load(std::memory_order_relaxed);
+  }
+
+  // In place allowed. Mono: pass the same buffers for both channels; only
+  // the left response is run then.
+  void process(const float *inL, const float *inR, float *outL, float *outR,
+               int numFrames, float mix) {
+    const float *in[2] = {inL, inR};
+    float *out[2] = {outL, outR};
+    mNumChannels = (inL == inR && outL == outR) ? 1 : 2;
+    const float dry = 1.0f - mix;
+
+    int done = 0;
+    while (done < numFrames) {
+      // Run up to the next head boundary; tail boundaries fall on head ones
+      const int n = std::min(numFrames - done, (int)kHeadBlock - mHeadPos);
+      for (int c = 0; c < mNumChannels; ++c) {
+        Channel &ch = mChannels[c];
+        float *window = ch.headWindow.data();
+        // All input is read before any output is written
+        std::copy_n(in[c] + done, n, window + kHeadBlock + mHeadPos);
+        std::copy_n(in[c] + done, n, ch.tailIn.data() + mTailPos);
+
+        const float *taps = ch.directTaps.data();
+        const float *head = ch.headOut.data() + mHeadPos;
+        const float *tail = ch.tailOut.data() + mTailPos;
+        float *o = out[c] + done;
+        for (int i = 0; i < n; ++i) {
+          const float *x = window + mHeadPos + i + 1;
+          float wet = head[i] + tail[i];
+          for (int j = 0; j < kHeadBlock; ++j)
+            wet += taps[j] * x[j];
+          o[i] = x[kHeadBlock - 1] * dry + wet * mix;
+        }
+      }
+      mHeadPos += n;
+      mTailPos += n;
+      done += n;
+
+      if (mHeadPos == kHeadBlock) {
+        for (int c = 0; c < mNumChannels; ++c) {
+          Channel &ch = mChannels[c];
+          ch.head.process(ch.headWindow.data(), ch.headOut.data());
+          std::copy_n(ch.headWindow.data() + kHeadBlock, (int)kHeadBlock,
+                      ch.headWindow.data());
+        }
+        mHeadPos = 0;
+      }
+      if (mTailPos == kTailBlock) {
+        if (mHasTail)
+          swapTail();
+        mTailPos = 0;
+      }
+    }
+  }
+
+  void process(const float *in, float *out, int numFrames, float mix) {
+    process(in, in, out, out, numFrames, mix);
+  }
+
+private:
+  static constexpr size_t kNoJob = ~(size_t)0;
+
+  struct Channel {
+    std::vector<float> directTaps; // reversed
+    std::vector<float> headWindow; // last 2 head blocks of input
+    std::vector<float> headOut;    // head segment output being played
+    PartitionedConvolver head;
+    std::vector<float> tailIn;     // render side: tail block being filled
+    std::vector<float> tailOut;    // render side: tail output being played
+    std::vector<float> jobIn;      // per job slot: the block to convolve
+    std::vector<float> jobOut;     // per job slot: its tail output
+    std::vector<float> tailWindow; // worker side: last 2 tail blocks
+    PartitionedConvolver tail;
+  };
+
+  // Render thread, at a tail boundary: play the output of the job queued
+  // two boundaries ago and queue the block just collected. Job j's slot is
+  // j % kTailJobs; the worker cannot reach it again before job j + 2 is
+  // queued, so it is safe to read here.
+  void swapTail() {
+    const size_t job = mJobs++;
+    if (job >= 2) {
+      const int played = (int)((job - 2) & (kTailJobs - 1));
+      const bool ready = mJobsDone.load(std::memory_order_acquire) >= job - 1;
+      for (auto &ch : mChannels) {
+        if (ready)
+          std::copy_n(ch.jobOut.data() + played * kTailBlock, (int)kTailBlock,
+                      ch.tailOut.data());
+        else
+          std::fill(ch.tailOut.begin(), ch.tailOut.end(), 0.0f);
+      }
+      if (!ready)
+        mMissedBlocks.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // The slot is free once the worker has taken the job it held before.
+    // If not, the block is lost and the worker convolves silence in its
+    // place, so the tail stays aligned.
+    const int slot = (int)(job & (kTailJobs - 1));
+    if (mJobsTaken.load(std::memory_order_acquire) + kTailJobs > job) {
+      for (auto &ch : mChannels)
+        std::copy_n(ch.tailIn.data(), (int)kTailBlock,
+                    ch.jobIn.data() + slot * kTailBlock);
+      mJobChannels[slot] = mNumChannels;
+      mJobStamps[slot].store(job, std::memory_order_release);
+    } else {
+      mMissedBlocks.fetch_add(1, std::memory_order_relaxed);
+    }
+    mJobsQueued.store(job + 1, std::memory_order_release);
+    mWake.signal();
+  }
+
+  void run() {
+    raiseWorkerPriority();
+    int channels = 2;
+    size_t job = 0;
+    while (true) {
+      mWake.wait();
+      if (!mRunning.load(std::memory_order_acquire))
+        return;
+      while (job < mJobsQueued.load(std::memory_order_acquire)) {
+        const int slot = (int)(job & (kTailJobs - 1));
+        const bool queued =
+            mJobStamps[slot].load(std::memory_order_acquire) == job;
+        if (queued)
+          channels = mJobChannels[slot];
+        for (int c = 0; c < channels; ++c) {
+          float *window = mChannels[c].tailWindow.data();
+          std::copy_n(window + kTailBlock, (int)kTailBlock, window);
+          if (queued)
+            std::copy_n(mChannels[c].jobIn.data() + slot * kTailBlock,
+                        (int)kTailBlock, window + kTailBlock);
+          else
+            std::fill_n(window + kTailBlock, (int)kTailBlock, 0.0f);
+        }
+        mJobsTaken.store(job + 1, std::memory_order_release);
+
+        for (int c = 0; c < channels; ++c)
+          mChannels[c].tail.process(mChannels[c].tailWindow.data(),
+                                    mChannels[c].jobOut.data() +
+                                        slot * kTailBlock);
+        mJobsDone.store(++job, std::memory_order_release);
+      }
+    }
+  }
+
+  Channel mChannels[2];
+  int mLength = 0;
+  bool mHasTail = false;
+  int mHeadPos = 0;
+  int mTailPos = 0;
+  int mNumChannels = 2;
+  // Job counters run freely; each is written by one side only
+  size_t mJobs = 0; // render side
+  int mJobChannels[kTailJobs] = {};
+  std::atomic<size_t> mJobStamps[kTailJobs];
+  std::atomic<size_t> mJobsQueued{0};
+  std::atomic<size_t> mJobsTaken{0};
+  std::atomic<size_t> mJobsDone{0};
+  std::atomic<unsigned> mMissedBlocks{0};
+  std::atomic<bool> mRunning{false};
+  WakeSemaphore mWake;
+  std::thread mThread;
+};
@@ -11,9 +11,23 @@
 #import <cmath>
 #import <vector>
 
+#import "AIVDenormals.hpp"
+#import "AIVFastMath.hpp"
+
 // Constants
 const double kPi = 3.14159265358979323846;
 
+// Passes around a feedback loop of the given gain until it has decayed by
+// 80 dB; a loop that does not decay never rings out
+inline double decayPasses(double loopGain) {
+  loopGain = std::fabs(loopGain);
+  if (loopGain >= 1.0)
+    return HUGE_VAL;
+  if (loopGain <= 0.0)
+    return 0.0;
+  return std::ceil(std::log(1e-4) / std::log(loopGain));
+}
+
 // Enum for identification of spectral bands
 enum SpectralBand {
   kBand_Sub,     // < 100 Hz
@@ -31,56 +45,69 @@ public:
     mTargetPeak_Output = -1.0f;
   }
 
+  // Analysis filter coefficients for the sample rate.
+  void initialize(double sampleRate) {
+    const double bandFreqs[kBands] = {200.0, 500.0, 2000.0, 5000.0};
+    mSampleRate = sampleRate;
+    // 1-pole coeff: 1 - exp(-2pi * freq / sr)
+    for (int band = 0; band < kBands; ++band)
+      mBandCoeff[band] =
+          (float)(1.0 - std::exp(-2.0 * kPi * bandFreqs[band] / sampleRate));
+  }
+
   // Called once per block to update control signals
   void processLogic(const float *inputBuffer, int numSamples,
                     float currentGateState, float currentCompGR,
                     double sampleRate) {
+    processLogic(&inputBuffer, 1, numSamples, currentGateState, currentCompGR,
+                 sampleRate);
+  }
+
+  // Linked analysis: the channels are analyzed together and the resulting
+  // controls are shared by all of them, so L and R cannot drift apart.
+  // Peak is the max across channels, RMS the mean power across channels
+  // (anti-phase content still reads), and the spectral bands run on the
+  // mid signal. With one channel this is the plain per-channel analysis.
+  void processLogic(const float *const *inputBuffers, int numChannels,
+                    int numSamples, float currentGateState,
+                    float currentCompGR, double sampleRate) {
 
     // Calculate coeffs if sample rate changed (approx check)
-    // 1-pole coeff: exp(-2pi * freq / sr)
-    if (sampleRate != mSampleRate) {
-      mSampleRate = sampleRate;
-      coeff200 = 1.0 - std::exp(-2.0 * kPi * 200.0 / sampleRate);
-      coeff500 = 1.0 - std::exp(-2.0 * kPi * 500.0 / sampleRate);
-      coeff2000 = 1.0 - std::exp(-2.0 * kPi * 2000.0 / sampleRate);
-      coeff5000 = 1.0 - std::exp(-2.0 * kPi * 5000.0 / sampleRate);
-    }
+    if (sampleRate != mSampleRate)
+      initialize(sampleRate);
 
     // 1. ANALYZE INPUT (Tap A) & SPECTRAL BANDS (Tap C)
     // We iterate the buffer to update filter states and accumulate energy
     float sumSq = 0.0f;
     float peak = 0.0f;
 
-    float sumMud = 0.0f;
-    float sumCore = 0.0f;
-    float sumScreech = 0.0f;
+    // Band energies: Mud (LPF500 - LPF200), Core (LPF2000 - LPF500),
+    // Screech (LPF5000 - LPF2000)
+    float bandSum[kBands - 1] = {};
+    const float midScale = 1.0f / numChannels;
 
     for (int i = 0; i < numSamples; ++i) {
-      float s = inputBuffer[i];
-      float absS = std::fabs(s);
-      if (absS > peak)
-        peak = absS;
-      sumSq += s * s;
+      float s = 0.0f;
+      float power = 0.0f;
+      for (int channel = 0; channel < numChannels; ++channel) {
+        const float x = inputBuffers[channel][i];
+        peak = std::max(peak, std::fabs(x));
+        power += x * x;
+        s += x;
+      }
+      sumSq += power * midScale;
+      s *= midScale;
 
-      // 1-pole LPFs
+      // 1-pole LPF bank, one lane per band
       // y += coeff * (x - y)
-      state200 += coeff200 * (s - state200);
-      state500 += coeff500 * (s - state500);
-      state2000 += coeff2000 * (s - state2000);
-      state5000 += coeff5000 * (s - state5000);
+      for (int band = 0; band < kBands; ++band)
+        mBandState[band] += mBandCoeff[band] * (s - mBandState[band]);
 
       // Band Isolation (Subtraction)
-      // Mud: 200-500Hz -> LPF500 - LPF200
-      float mudSample = state500 - state200;
-      sumMud += mudSample * mudSample;
-
-      // Core: 500-2000Hz -> LPF2000 - LPF500
-      float coreSample = state2000 - state500;
-      sumCore += coreSample * coreSample;
-
-      // Screech: 2000-5000Hz -> LPF5000 - LPF2000
-      float screechSample = state5000 - state2000;
-      sumScreech += screechSample * screechSample;
+      for (int band = 0; band < kBands - 1; ++band) {
+        const float bandSample = mBandState[band + 1] - mBandState[band];
+        bandSum[band] += bandSample * bandSample;
+      }
     }
 
     float inputRMS = std::sqrt(sumSq / numSamples + 1e-9f);
@@ -111,9 +138,9 @@ public:
     mCompThresholdOffset = mAutoLevelGainDB;
 
     // 5. SPECTRAL LOGIC
-    float mudRMS = std::sqrt(sumMud / numSamples + 1e-9f);
-    float coreRMS = std::sqrt(sumCore / numSamples + 1e-9f);
-    float screechRMS = std::sqrt(sumScreech / numSamples + 1e-9f);
+    float mudRMS = std::sqrt(bandSum[0] / numSamples + 1e-9f);
+    float coreRMS = std::sqrt(bandSum[1] / numSamples + 1e-9f);
+    float screechRMS = std::sqrt(bandSum[2] / numSamples + 1e-9f);
 
     // MUD CUT
     // If Mud is > Core (Reference: Pink noise, Mud should be ~equal or less
@@ -139,6 +166,25 @@ public:
     }
   }
 
+  // Snapshot of every control output, for handing across threads
+  struct Controls {
+    float safetyPad = 1.0f;
+    float autoLevelGain = 0.0f;
+    float compThresholdAdjust = 0.0f;
+    float mudEqCut = 0.0f;
+    float satDriveScaler = 1.0f;
+  };
+
+  Controls getControls() const {
+    Controls c;
+    c.safetyPad = mSafetyPadGain;
+    c.autoLevelGain = mAutoLevelGainDB;
+    c.compThresholdAdjust = mCompThresholdOffset;
+    c.mudEqCut = mMudCutDB;
+    c.satDriveScaler = mSatDriveScaler;
+    return c;
+  }
+
   float getSafetyPad() const { return mSafetyPadGain; }
   float getAutoLevelGain() const { return mAutoLevelGainDB; }
   float getCompThresholdAdjust() const { return mCompThresholdOffset; }
@@ -155,10 +201,11 @@ private:
   float mTargetRMS_Input;
   float mTargetPeak_Output;
 
-  // Analysis Filters
-  double mSampleRate = 44100.0;
-  float state200 = 0, state500 = 0, state2000 = 0, state5000 = 0;
-  float coeff200 = 0, coeff500 = 0, coeff2000 = 0, coeff5000 = 0;
+  // Analysis Filters: 1-pole LPFs at 200, 500, 2000 and 5000 Hz
+  static constexpr int kBands = 4;
+  double mSampleRate = 0.0;
+  float mBandState[kBands] = {};
+  float mBandCoeff[kBands] = {};
 
   float calculateRMS(const float *buffer, int numSamples) {
     // unused helper now integrated in main loop
@@ -224,8 +271,8 @@ public:
     double lp = g * bp + s2;
 
     // Update states
-    s1 = 2.0 * bp - s1;
-    s2 = 2.0 * lp - s2;
+    s1 = flushDenormal(2.0 * bp - s1);
+    s2 = flushDenormal(2.0 * lp - s2);
 
     if (type == HighPass) {
       return (float)hp;
@@ -269,6 +316,12 @@ public:
     s2 = 0;
   }
 
+  // Block form: runs the filter in place over a contiguous span
+  void processBlock(float *buffer, int numSamples) {
+    for (int i = 0; i < numSamples; ++i)
+      buffer[i] = process(buffer[i]);
+  }
+
 private:
   Type type = HighPass;
   double g = 0.0;
@@ -350,7 +403,8 @@ public:
   }
 
   float process(float input) {
-    double output = b0 * input + b1 * x1 + b2 * x2 - a1 * y1 - a2 * y2;
+    const double output =
+        flushDenormal(b0 * input + b1 * x1 + b2 * x2 - a1 * y1 - a2 * y2);
     x2 = x1;
     x1 = input;
     y2 = y1;
@@ -360,18 +414,99 @@ public:
 
   void reset() { x1 = x2 = y1 = y2 = 0; }
 
+  void processBlock(float *buffer, int numSamples) {
+    for (int i = 0; i < numSamples; ++i)
+      buffer[i] = process(buffer[i]);
+  }
+
+  // Normalized coefficients (a0 == 1)
+  struct Coefficients {
+    double b0 = 0, b1 = 0, b2 = 0, a1 = 0, a2 = 0;
+  };
+
+  static Coefficients design(Type type, double freq, double Q, double dbGain,
+                             double sampleRate) {
+    BiquadFilter filter;
+    filter.calculateCoefficients(type, freq, Q, dbGain, sampleRate);
+    return filter.getCoefficients();
+  }
+
+  Coefficients getCoefficients() const { return {b0, b1, b2, a1, a2}; }
+
 private:
   double b0 = 0, b1 = 0, b2 = 0, a0 = 1.0, a1 = 0, a2 = 0;
   double x1 = 0, x2 = 0, y1 = 0, y2 = 0;
 };
 
+// --- Control-Rate Gain ---
+// The dynamics modules run their detectors per sample, but their gain laws
+// (pow / dB conversions) only once per segment of `interval` samples. The
+// detectors are feed-forward, so each segment is detected first and the gain
+// law evaluated at its last sample; this then ramps from the previous
+// segment's gain to that one across the segment. The gain therefore matches
+// the per-sample path exactly at every segment end, with no added lag. A
+// host block that ends mid-interval closes a shorter segment.
+// Cubic uses a Hermite segment whose tangents come from the last three
+// control points, so it needs no future point.
+// Against the per-sample path (48k, 48 dB instantaneous level steps, the
+// worst case) the output error stays at least 37 / 35 / 29 dB below the
+// signal at N = 8 / 16 / 32, with the gain within 0.05 / 0.05 / 0.1 dB for
+// 99% of samples (FET compressor; the other modules track closer).
+// LogicAIV/Tests/ControlRateTest checks these bounds for every lane module
+// in AIVDSPLanes.hpp against the scalar modules' per-sample process().
+class ControlRateGain {
+public:
+  enum Interpolation { Linear, Cubic };
+
+  // interval: 8, 16 or 32 samples
+  void setInterval(int n) { interval = (n <= 8) ? 8 : (n <= 16 ? 16 : 32); }
+
+  void setInterpolation(Interpolation mode) { this->mode = mode; }
+
+  int getInterval() const { return interval; }
+
+  void reset(float gain) {
+    p0 = p1 = gain;
+    a = b = c = 0.0f;
+    d = gain;
+  }
+
+  // Ramp from the last control point to `gain` across the next segment;
+  // at() evaluates it
+  void beginSegment(float gain) {
+    const float p2 = gain;
+    if (mode == Cubic) {
+      const float m1 = 0.5f * (p2 - p0); // central difference at p1
+      const float m2 = p2 - p1;          // backward difference at p2
+      a = 2.0f * p1 - 2.0f * p2 + m1 + m2;
+      b = -3.0f * p1 + 3.0f * p2 - 2.0f * m1 - m2;
+      c = m1;
+    } else {
+      a = b = 0.0f;
+      c = p2 - p1;
+    }
+    d = p1;
+    p0 = p1;
+    p1 = p2;
+  }
+
+  // Segment value at t in (0, 1]; t = 1 is the new control point
+  float at(float t) const { return ((a * t + b) * t + c) * t + d; }
+
+private:
+  Interpolation mode = Linear;
+  int interval = 16;
+  float p0 = 1.0f, p1 = 1.0f;
+  float a = 0.0f, b = 0.0f, c = 0.0f, d = 1.0f;
+};
+
 // --- Auto Level (AGC) ---
 class AutoLevel {
 public:
   void setParameters(double targetDb, double rangeDb, double speed,
                      double sampleRate) {
-    targetLevel = pow(10.0, targetDb / 20.0);
-    maxGain = pow(10.0, rangeDb / 20.0);
+    this->targetDb = targetDb;
+    this->rangeDb = rangeDb;
     // Speed 0-100% maps to attack/release times
     double attackMs = 1000.0 - (speed * 9.0); // 100ms to 1000ms
     double releaseMs = attackMs * 2.0;
@@ -382,6 +517,7 @@ public:
 
   void setGainOffset(double db) {
     externalGainDb = db;
+    externalGain = pow(10.0, db / 20.0);
     useExternalGain = true;
   }
 
@@ -393,7 +529,7 @@ public:
     // The prompt says "AutoLevel Gain" from Normalizer is the *Gain to apply*.
 
     if (useExternalGain) {
-      double targetG = pow(10.0, externalGainDb / 20.0);
+      double targetG = externalGain;
       // Smooth the transition to the externally commanded gain
       // reusing attackCoef (or a fixed fast smoothing)
       currentGain = attackCoef * (currentGain - targetG) + targetG;
@@ -408,34 +544,33 @@ public:
     else
       envelope = releaseCoef * (envelope - absInput) + absInput;
 
+    return input * computeGain();
+  }
+
+private:
+  float computeGain() const {
     if (envelope < 0.0001)
-      return input;
+      return 1.0f;
 
     // Calculate required gain to hit target
-    double currentDb = 20.0 * log10(envelope);
-    double targetDbVal = 20.0 * log10(targetLevel);
-    double gainDb = targetDbVal - currentDb;
+    float currentDb = FastMath::linToDb((float)envelope);
+    float gainDb = (float)targetDb - currentDb;
 
     // Clamp gain
-    if (gainDb > 20.0 * log10(maxGain))
-      gainDb = 20.0 * log10(maxGain);
-    if (gainDb < -20.0 * log10(maxGain))
-      gainDb = -20.0 * log10(maxGain);
-
-    double gain = pow(10.0, gainDb / 20.0);
+    gainDb = std::max((float)-rangeDb, std::min(gainDb, (float)rangeDb));
 
-    return input * gain;
+    return FastMath::dbToLin(gainDb);
   }
 
-private:
-  double targetLevel = 0.5;
-  double maxGain = 2.0;
   double attackCoef = 0.0;
   double releaseCoef = 0.0;
   double envelope = 0.0;
+  double targetDb = -6.0;
+  double rangeDb = 6.0; // Max boost / cut
 
   // CrossNormalizer Support
   double externalGainDb = 0.0;
+  double externalGain = 1.0;
   bool useExternalGain = false;
   double currentGain = 1.0;
 };
@@ -536,6 +671,7 @@ public:
                      double ratio, double sampleRate) {
     this->threshold = pow(10.0, thresholdDb / 20.0);
     this->ratio = ratio;
+    this->grExponent = (float)(1.0 / ratio - 1.0);
     this->maxAttenuation = pow(10.0, rangeDb / 20.0); // e.g. -6dB = 0.5
 
     // Split Band Architecture:
@@ -556,35 +692,38 @@ public:
     float highBand = input - lowBand;
 
     // Detect on High Band
-    double absHigh = fabs(highBand);
+    detect(highBand);
 
-    // Envelope
+    // Apply GR to HighBand only
+    float processedHigh = highBand * computeGain();
+
+    // Sum back
+    return lowBand + processedHigh;
+  }
+
+private:
+  void detect(float highBand) {
+    double absHigh = fabs(highBand);
     if (absHigh > envelope)
       envelope = attack * (envelope - absHigh) + absHigh;
     else
       envelope = release * (envelope - absHigh) + absHigh;
+  }
 
+  float computeGain() const {
     // Gain reduction
-    double gain = 1.0;
-    if (envelope > threshold) {
-      gain = pow(envelope / threshold, 1.0 / ratio - 1.0);
-    }
+    float gain = 1.0f;
+    if (envelope > threshold)
+      gain = FastMath::pow((float)(envelope / threshold), grExponent);
 
     // Range Check
-    if (gain < maxAttenuation)
-      gain = maxAttenuation;
-
-    // Apply GR to HighBand only
-    float processedHigh = highBand * gain;
-
-    // Sum back
-    return lowBand + processedHigh;
+    return std::max(gain, (float)maxAttenuation);
   }
 
-private:
   BiquadFilter crossoverFilter;
   double threshold = 0.5;
   double ratio = 5.0;
+  float grExponent = -0.8f; // 1/ratio - 1
   double maxAttenuation = 0.5;
   double envelope = 0.0;
   double attack = 0.0;
@@ -602,6 +741,7 @@ public:
 
     // 2. Ratio
     this->ratio = ratio;
+    this->grExponent = (float)(1.0 / ratio - 1.0);
 
     // 3. Time Constants (Microseconds for Attack)
     // Attack: 20us to 800us.
@@ -628,7 +768,10 @@ public:
   }
 
   void setAutoMakeup(bool enabled) { this->autoMakeup = enabled; }
-  void setThresholdOffset(double db) { this->thresholdOffsetDb = db; }
+  void setThresholdOffset(double db) {
+    thresholdOffsetDb = db;
+    effectiveThreshold = threshold * pow(10.0, db / 20.0);
+  }
 
   float process(float input) {
     // Apply Input Drive
@@ -637,8 +780,7 @@ public:
 
     // Apply Threshold Offset from CrossNormalizer (inverse to AutoLevel gain)
     // If AutoLevel adds gain (+dB), we raise threshold (+dB) so compression
-    // amount stays consistent
-    double effectiveThreshold = threshold * pow(10.0, thresholdOffsetDb / 20.0);
+    // amount stays consistent (effectiveThreshold, set per block)
 
     // Envelope
     if (absInput > envelope)
@@ -646,269 +788,547 @@ public:
     else
       envelope = releaseCoeff * (envelope - absInput) + absInput;
 
-    // Gain Reduction
-    double gain = 1.0;
-    if (envelope > effectiveThreshold) {
-      // Gain reduction formula
-      // GR = (env / thresh) ^ (1/R - 1)
-      gain = pow(envelope / effectiveThreshold, 1.0 / ratio - 1.0);
-    }
-
     // Apply GR to the driven signal (or original? Standard 1176: Input gain IS
     // the volume knob) So output is drivenSignal * gain * makeup.
-    return (float)(drivenSignal * gain * makeupGain);
+    return (float)(drivenSignal * computeGain() * makeupGain);
   }
 
 private:
+  float computeGain() const {
+    // Gain reduction formula
+    // GR = (env / thresh) ^ (1/R - 1)
+    if (envelope > effectiveThreshold)
+      return FastMath::pow((float)(envelope / effectiveThreshold), grExponent);
+    return 1.0f;
+  }
+
   double inputGain = 1.0;
   double threshold = 0.1; // -20dB
   double ratio = 4.0;
+  float grExponent = -0.75f; // 1/ratio - 1
   double attackCoeff = 0.0;
   double releaseCoeff = 0.0;
   double makeupGain = 1.0;
   double envelope = 0.0;
   bool autoMakeup = false;
   double thresholdOffsetDb = 0.0;
+  double effectiveThreshold = 0.1;
 };
 
-// --- True Peak Limiter (Lookahead + Sinc) ---
+// --- True Peak Detector (ITU-R BS.1770-4, 4x Polyphase) ---
+// Estimates each sample's true peak with the 4x oversampling interpolator
+// of BS.1770-4 Annex 2: 48 taps in four 12-tap phases. The phases are
+// stored interleaved per tap, so a sample is 12 steps of one 4-wide
+// multiply-add with the four phase accumulators side by side. History is
+// linear, as in HalfBandStage, so the window never wraps.
+class TruePeakDetector {
+public:
+  static constexpr int kPhases = 4;
+  static constexpr int kTaps = 12; // per phase
+  static constexpr int kChunk = 256;
+  // The phases interpolate between the samples this far back and one
+  // later, so a peak is reported this many samples after its input
+  static constexpr int kDelay = kTaps / 2;
+
+  TruePeakDetector() { reset(); }
+
+  void reset() { std::fill(history, history + kTaps - 1 + kChunk, 0.0f); }
+
+  // peaks[i]: largest magnitude of the input sample kDelay back and the
+  // four interpolated points that follow it. In place allowed.
+  void process(const float *input, float *peaks, int numSamples) {
+    // Annex 2 phases, interleaved: kCoeffs[j] holds tap j of every phase,
+    // oldest input first
+    static const float kCoeffs[kTaps][kPhases] = {
+        {-0.0083007812500f, -0.0189208984375f, -0.0291748046875f,
+         0.0017089843750f},
+        {0.0148925781250f, 0.0330810546875f, 0.0292968750000f,
+         0.0109863281250f},
+        {-0.0266113281250f, -0.0582275390625f, -0.0517578125000f,
+         -0.0196533203125f},
+        {0.0476074218750f, 0.1015625000000f, 0.0891113281250f,
+         0.0332031250000f},
+        {-0.1022949218750f, -0.2003173828125f, -0.1665039062500f,
+         -0.0594482421875f},
+        {0.9721679687500f, 0.7797851562500f, 0.4650878906250f,
+         0.1373291015625f},
+        {0.1373291015625f, 0.4650878906250f, 0.7797851562500f,
+         0.9721679687500f},
+        {-0.0594482421875f, -0.1665039062500f, -0.2003173828125f,
+         -0.1022949218750f},
+        {0.0332031250000f, 0.0891113281250f, 0.1015625000000f,
+         0.0476074218750f},
+        {-0.0196533203125f, -0.0517578125000f, -0.0582275390625f,
+         -0.0266113281250f},
+        {0.0109863281250f, 0.0292968750000f, 0.0330810546875f,
+         0.0148925781250f},
+        {0.0017089843750f, -0.0291748046875f, -0.0189208984375f,
+         -0.0083007812500f}};
+    const int hist = kTaps - 1;
+
+    while (numSamples > 0) {
+      const int n = std::min(numSamples, (int)kChunk);
+      std::copy_n(input, n, history + hist);
+
+      for (int i = 0; i < n; ++i) {
+        const float *x = history + i;
+        float acc[kPhases] = {0.0f, 0.0f, 0.0f, 0.0f};
+        for (int j = 0; j < kTaps; ++j)
+          for (int p = 0; p < kPhases; ++p)
+            acc[p] += kCoeffs[j][p] * x[j];
+        float peak = std::fabs(x[hist - kDelay]);
+        for (int p = 0; p < kPhases; ++p)
+          peak = std::max(peak, std::fabs(acc[p]));
+        peaks[i] = peak;
+      }
+
+      std::copy_n(history + n, hist, history);
+      input += n;
+      peaks += n;
+      numSamples -= n;
+    }
+  }
+
+private:
+  // [kTaps - 1 previous samples | current chunk]
+  float history[kTaps - 1 + kChunk];
+};
+
+// --- True Peak Limiter (Lookahead + BS.1770 Detection) ---
 // Research: 11.2 Inter-Sample Peak Detection
-// Uses 4x Oversampling (Sinc Interpolation) to detect True Peaks.
-// Uses Lookahead Buffer to catch transients before they clip.
+// Detects true peaks with TruePeakDetector in the sidechain and turns them
+// into a gain that is already down when each peak reaches the output:
+//   1. target gain per detected peak (ceiling / peak)
+//   2. minimum held over the lookahead window (monotonic deque)
+//   3. release (one-pole, upwards only)
+//   4. attack: moving average over the lookahead window (running sum)
+// The moving average reaches the held minimum exactly as the peak leaves
+// the lookahead delay, so the attack is a ramp instead of a step and the
+// ceiling still holds. Every stage is O(1) per sample whatever the
+// lookahead.
+// Linked (setChannelCount > 1), each channel keeps its detector and delay
+// and the loudest channel's peak drives one gain for all of them.
 class TruePeakLimiter {
 public:
+  static constexpr int kBufferSize = 4096; // power of two; ~21ms at 192k
+  // Added to the lookahead so it is counted from the detected peak
+  static constexpr int kDetectorDelay = TruePeakDetector::kDelay;
+
   TruePeakLimiter() {
-    buffer.resize(4096, 0.0f); // Max ~90ms at 44.1k
+    setChannelCount(1);
+    gains.resize(kBufferSize, 1.0f);
+    minValues.resize(kBufferSize, 1.0f);
+    minTimes.resize(kBufferSize, 0);
+    setAttackLength(attackLength(lookaheadDelay));
   }
 
-  void setParameters(double ceilingDb, double lookaheadMs, double releaseMs,
-                     double sampleRate) {
-    this->ceiling = pow(10.0, ceilingDb / 20.0);
+  struct Coefficients {
+    double ceiling = 1.0;
+    int lookaheadDelay = 88 + kDetectorDelay;
+    double releaseCoeff = 0.0;
+  };
+
+  static Coefficients design(double ceilingDb, double lookaheadMs,
+                             double releaseMs, double sampleRate) {
+    Coefficients c;
+    c.ceiling = pow(10.0, ceilingDb / 20.0);
 
     int lookaheadSamples = (int)(lookaheadMs / 1000.0 * sampleRate);
     if (lookaheadSamples < 1)
       lookaheadSamples = 1;
-    this->lookaheadDelay = lookaheadSamples;
+    c.lookaheadDelay =
+        std::min(lookaheadSamples + kDetectorDelay, kBufferSize - 1);
 
-    this->releaseCoeff = exp(-1.0 / (sampleRate * releaseMs / 1000.0));
+    c.releaseCoeff = exp(-1.0 / (sampleRate * releaseMs / 1000.0));
+    return c;
   }
 
-  float process(float input) {
-    // 1. Write to Lookahead Buffer
-    buffer[writeIndex] = input;
-
-    // 2. Read Delayed Output (Audio Path)
-    int readIndex = writeIndex - lookaheadDelay;
-    if (readIndex < 0)
-      readIndex += buffer.size();
-    float delayedOutput = buffer[readIndex];
-
-    // 3. Detect True Peak in Sidechain (Scanning ahead)
-    // We scan the 'input' (which is 'lookaheadDelay' samples in the future
-    // relative to output) AND its neighbors for ISP. Simplified 4x oversampling
-    // check: A true 4x sinc is expensive. Fast approximation: Check current
-    // sample and mid-points using polynomial.
-
-    // For strict True Peak, we should upsample.
-    // Here we use a conservative 4-point cubic measurement of the *current*
-    // input to estimate if a peak exists between samples. Ideally we check the
-    // buffer around 'writeIndex'.
-
-    float maxPeak = fabs(input);
-
-    // Check 3 points back for interpolation context
-    int i0 = writeIndex - 3;
-    if (i0 < 0)
-      i0 += buffer.size();
-    float y0 = buffer[i0];
-
-    int i1 = writeIndex - 2;
-    if (i1 < 0)
-      i1 += buffer.size();
-    float y1 = buffer[i1];
-
-    int i2 = writeIndex - 1;
-    if (i2 < 0)
-      i2 += buffer.size();
-    float y2 = buffer[i2];
-
-    float y3 = input; // current
-
-    // Cubic Interpolation to find peaks between y1 and y2
-    // Detect inter-sample peak:
-    // Simple heuristic: if y1 and y2 are both high, check midpoint.
-    // Midpoint (0.5) via cubic:
-    // c0*y0 + c1*y1 + c2*y2 + c3*y3 (with d=0.5)
-    // coeffs for d=0.5: -0.0625, 0.5625, 0.5625, -0.0625
-    float mid = -0.0625f * y0 + 0.5625f * y1 + 0.5625f * y2 - 0.0625f * y3;
-    if (fabs(mid) > maxPeak)
-      maxPeak = fabs(mid);
-
-    // 4. Update Gain Reduction Envelope
-    // Attack is instant (0ms) relative to the lookahead.
-    // Actually, attack time = lookahead time.
-    // We map the peak to the delayed signal?
-    // Standard Lookahead Limiter:
-    // Peak is detected 'lookahead' samples ahead.
-    // Target Gain = Ceiling / Peak.
-    // if Peak > Ceiling, Gain < 1.0.
-    // We smooth this target gain over the lookahead window?
-    // Or simply:
-
-    double targetGain = 1.0;
-    if (maxPeak > ceiling) {
-      targetGain = ceiling / maxPeak;
+  void setCoefficients(const Coefficients &c) {
+    ceiling = c.ceiling;
+    releaseCoeff = c.releaseCoeff;
+    if (c.lookaheadDelay != lookaheadDelay) {
+      lookaheadDelay = c.lookaheadDelay;
+      setAttackLength(attackLength(lookaheadDelay));
     }
+  }
 
-    // Release Logic
-    if (targetGain < envelope) {
-      // Attack (Instant/Fast)
-      envelope = targetGain;
-    } else {
-      // Release (Slow recovery)
-      envelope = releaseCoeff * (envelope - targetGain) + targetGain;
-    }
+  void setParameters(double ceilingDb, double lookaheadMs, double releaseMs,
+                     double sampleRate) {
+    setCoefficients(design(ceilingDb, lookaheadMs, releaseMs, sampleRate));
+  }
 
-    // 5. Apply Gain to *Delayed* Output
-    // Note: The envelope calculated from 'input' (future) is applied to
-    // 'delayedOutput' (now). This effectively aligns the gain reduction with
-    // the transient. Wait, if we detect a peak NOW (in input), we need to
-    // reduce gain NOW? No, the peak is in the future relative to the output. So
-    // we need to delay the control signal? Or is the envelope *already*
-    // applying to the future? Standard: Buffer audio. Derive gain from Input
-    // (Future). Smooth gain. Apply smoothed gain to Delayed Audio. This means
-    // the gain dips *before* the transient arrives at the output.
+  // Not real-time safe: one detector and lookahead delay per channel
+  void setChannelCount(int numChannels) {
+    channels.resize(std::max(1, numChannels));
+    for (auto &c : channels)
+      c.buffer.resize(kBufferSize, 0.0f);
+  }
 
-    // The release needs to be correct.
-    // Let's us a simple "Hold" on the gain for lookahead samples?
+  float process(float input) {
+    float peak;
+    channels[0].detector.process(&input, &peak, 1);
+    const float gain = computeGain(peak);
+    const float out = delay(channels[0], input) * gain;
+    writeIndex = (writeIndex + 1) & kMask;
+    return out;
+  }
 
-    // Simply applying the envelope derived from Input to DelayedOutput works
-    // if the attack time matches the lookahead.
-    // If we set envelope = targetGain immediately, the gain drops *lookahead*
-    // samples early. This is a "pre-attack". Perfect.
+  void processBlock(float *buffer, int numSamples) {
+    processBlock(&buffer, 1, numSamples);
+  }
 
-    float out = delayedOutput * (float)envelope;
+  // Detection runs a chunk at a time, then the gain pass. numChannels up to
+  // setChannelCount; more than one links them. Buffers are indexed by
+  // channel, so each keeps its own detector and delay; a null buffer is a
+  // channel absent from this call.
+  void processBlock(float *const *buffers, int numChannels, int numSamples) {
+    float peaks[TruePeakDetector::kChunk];
+    float channelPeaks[TruePeakDetector::kChunk];
+    numChannels = std::min(numChannels, (int)channels.size());
+    for (int done = 0; done < numSamples;) {
+      const int n = std::min(numSamples - done, (int)TruePeakDetector::kChunk);
+      std::fill_n(peaks, n, 0.0f);
+      for (int c = 0; c < numChannels; ++c) {
+        if (!buffers[c])
+          continue;
+        channels[c].detector.process(buffers[c] + done, channelPeaks, n);
+        for (int i = 0; i < n; ++i)
+          peaks[i] = std::max(peaks[i], channelPeaks[i]);
+      }
 
-    writeIndex++;
-    if (writeIndex >= buffer.size())
-      writeIndex = 0;
+      for (int i = 0; i < n; ++i) {
+        const float gain = computeGain(peaks[i]);
+        for (int c = 0; c < numChannels; ++c) {
+          if (!buffers[c])
+            continue;
+          float &x = buffers[c][done + i];
+          x = delay(channels[c], x) * gain;
+        }
+        writeIndex = (writeIndex + 1) & kMask;
+      }
+      done += n;
+    }
+  }
 
-    return out;
+  // Current gain before the attack average; lower is more reduction
+  float heldGain() const { return releaseGain; }
+
+  // Render thread, on a switch between limiters: carry on from the gain
+  // state of another limiter with the same coefficients, then take its
+  // channels' lookahead audio with continueChannel(), so the switch neither
+  // drops samples nor lets go of reduction already under way
+  void continueFrom(const TruePeakLimiter &source) {
+    writeIndex = source.writeIndex;
+    minValues = source.minValues;
+    minTimes = source.minTimes;
+    minFront = source.minFront;
+    minBack = source.minBack;
+    time = source.time;
+    releaseGain = source.releaseGain;
+    gains = source.gains;
+    attack = source.attack;
+    attackSum = source.attackSum;
+  }
+
+  void continueChannel(int channel, const TruePeakLimiter &source,
+                       int sourceChannel) {
+    Channel &to = channels[channel];
+    const Channel &from = source.channels[sourceChannel];
+    to.detector = from.detector;
+    // Aligned on the write positions, which differ when the source ran
+    // without some of our channels
+    for (int i = 0; i < kBufferSize; ++i)
+      to.buffer[(writeIndex + i) & kMask] =
+          from.buffer[(source.writeIndex + i) & kMask];
   }
 
 private:
-  std::vector<float> buffer;
+  static constexpr int kMask = kBufferSize - 1;
+
+  // A detected peak covers its input sample and the next one, which leave
+  // the delay lookaheadDelay - kDetectorDelay and one sample later. The
+  // average spans one sample more than that and the minimum is held one
+  // sample longer again, so both see the full reduction.
+  static int attackLength(int lookaheadDelay) {
+    return lookaheadDelay - kDetectorDelay + 1;
+  }
+
+  // Render thread, on a lookahead change: re-sum the stored gains
+  void setAttackLength(int length) {
+    attack = length;
+    attackSum = 0.0;
+    for (int i = 1; i <= attack; ++i)
+      attackSum += gains[(writeIndex - i) & kMask];
+  }
+
+  struct Channel {
+    TruePeakDetector detector;
+    std::vector<float> buffer; // lookahead delay
+  };
+
+  // Audio path: write to the lookahead buffer, read the delayed output.
+  // The caller advances writeIndex once per frame.
+  float delay(Channel &channel, float input) {
+    channel.buffer[writeIndex] = input;
+    return channel.buffer[(writeIndex - lookaheadDelay) & kMask];
+  }
+
+  // Gain for the delayed output of this frame, from the peak detected at
+  // its input
+  float computeGain(float peak) {
+    // 1. Target gain, and the minimum over the last attack + 1 targets.
+    // The deque keeps increasing values: a new target drops every larger
+    // one behind it, and the front leaves once it is out of the window.
+    const float target = peak > ceiling ? (float)(ceiling / peak) : 1.0f;
+    while (minBack != minFront && minValues[(minBack - 1) & kMask] >= target)
+      --minBack;
+    minValues[minBack & kMask] = target;
+    minTimes[minBack & kMask] = time;
+    ++minBack;
+    while (time - minTimes[minFront & kMask] > (unsigned)attack)
+      ++minFront;
+    const float held = minValues[minFront & kMask];
+
+    // 2. Release: drops follow at once, recovery is slow
+    if (held < releaseGain)
+      releaseGain = held;
+    else
+      releaseGain = (float)(releaseCoeff * (releaseGain - held) + held);
+
+    // 3. Attack: average of the last attack gains
+    attackSum += releaseGain - gains[(writeIndex - attack) & kMask];
+    gains[writeIndex] = releaseGain;
+    ++time;
+    return (float)(attackSum / attack);
+  }
+
+  std::vector<Channel> channels;
   int writeIndex = 0;
-  int lookaheadDelay = 88; // 2ms at 44.1k
+  int lookaheadDelay = 88 + kDetectorDelay; // 2ms at 44.1k
   double ceiling = 1.0;
   double releaseCoeff = 0.0;
-  double envelope = 1.0;
+
+  // Sliding minimum: a ring of (value, time) pairs between front and back
+  std::vector<float> minValues;
+  std::vector<unsigned> minTimes;
+  unsigned minFront = 0, minBack = 0, time = 0;
+
+  float releaseGain = 1.0f;
+  // Moving average over the released gains
+  std::vector<float> gains;
+  int attack = 1;
+  double attackSum = 0.0;
 };
 
 // --- Delay Line (Lagrange Interpolation) ---
 // Research: 10.1 Delay Interpolation Physics
 // 4th-order Lagrange Interpolation prevents "zipper noise" and aliasing
 // during time modulation (tape echo effects).
+// The line is a power-of-two ring addressed with a mask. Blocks are cut
+// into spans that neither wrap nor read what the same span writes, and
+// each span takes the cheapest path for the delay it sees:
+//   - settled on a whole number of samples: a straight copy of the
+//     delayed span plus the feedback multiply-add
+//   - settled between samples: one set of Lagrange weights for the span
+//   - gliding toward a new time: per-sample weights, the glide for the
+//     span computed first so the interpolation loop has no recurrence
 class DelayLine {
 public:
-  void setParameters(double timeSec, double feedback, double mix,
-                     double sampleRate) {
-    this->targetDelay = timeSec * sampleRate;
-    this->feedback = feedback / 100.0;
-    this->mix = mix / 100.0;
+  static constexpr double kMaxSeconds = 2.0;
+
+  void initialize(double sampleRate) {
+    // Two seconds plus the interpolation taps
+    const int needed = (int)(sampleRate * kMaxSeconds) + kMinDelay;
+    int size = 1;
+    while (size < needed)
+      size <<= 1;
+    if ((int)buffer.size() != size) {
+      buffer.assign(size, 0.0f);
+      mask = size - 1;
+      writeIndex = 0;
+    }
+    maxDelay = (double)(size - kChunk - kMinDelay);
+  }
+
+  struct Coefficients {
+    double targetDelay = 0;
+    double feedback = 0, mix = 0;
+  };
+
+  static Coefficients design(double timeSec, double feedback, double mix,
+                             double sampleRate) {
+    Coefficients c;
+    c.targetDelay = std::max((double)kMinDelay, timeSec * sampleRate);
+    c.feedback = feedback / 100.0;
+    c.mix = mix / 100.0;
+    return c;
+  }
+
+  void setCoefficients(const Coefficients &c) {
+    targetDelay = std::min(c.targetDelay, maxDelay);
+    feedback = (float)c.feedback;
+    mix = (float)c.mix;
 
     // Smooth delay time changes
     if (currentDelay == 0)
       currentDelay = targetDelay;
+  }
 
-    if (buffer.size() != (int)(sampleRate * 2.0)) { // Max 2 sec buffer
-      buffer.resize((int)(sampleRate * 2.0), 0);
-    }
+  void setParameters(double timeSec, double feedback, double mix,
+                     double sampleRate) {
+    initialize(sampleRate);
+    setCoefficients(design(timeSec, feedback, mix, sampleRate));
+  }
+
+  // Samples the echoes ring on after the input stops
+  static double tailSamples(const Coefficients &c) {
+    return c.targetDelay * (1.0 + decayPasses(c.feedback));
   }
 
   float process(float input) {
+    processBlock(&input, 1);
+    return input;
+  }
+
+  void processBlock(float *io, int numSamples) {
     if (buffer.empty())
-      return input;
-
-    // Smooth delay time (Simple LPF on the delay time itself)
-    currentDelay = 0.999 * currentDelay + 0.001 * targetDelay;
-
-    // 4th-Order Lagrange Interpolation
-    // We need 4 points around the fractional delay.
-    // readPos = writeIndex - currentDelay
-    double readPos = writeIndex - currentDelay;
-    while (readPos < 0)
-      readPos += buffer.size();
-    while (readPos >= buffer.size())
-      readPos -= buffer.size();
-
-    int i = (int)readPos;
-    double frac = readPos - i;
-
-    // Indices for 4 points: i-1, i, i+1, i+2
-    // Optimizing relative to 'i' being the floor.
-    // Actually standard Lagrange 4-point usually takes y[n-1], y[n], y[n+1],
-    // y[n+2] relative to the fractional position? Let's treat 'frac' as delta
-    // from sample 'i'. We need indices: i-1, i, i+1, i+2
-
-    int i0 = i - 1;
-    int i1 = i;
-    int i2 = i + 1;
-    int i3 = i + 2;
-
-    // Wrap indices
-    if (i0 < 0)
-      i0 += buffer.size();
-    if (i1 >= buffer.size())
-      i1 -= buffer.size();
-    if (i2 >= buffer.size())
-      i2 -= buffer.size();
-    if (i3 >= buffer.size())
-      i3 -= buffer.size();
-
-    float y0 = buffer[i0];
-    float y1 = buffer[i1];
-    float y2 = buffer[i2];
-    float y3 = buffer[i3];
-
-    // Lagrange Coefficients (4th order / Cubic)
-    // d = frac (0..1)
-    // Common coefficients for cubic Lagrange:
-    // c0 = -d * (d-1) * (d-2) / 6
-    // c1 = (d+1) * (d-1) * (d-2) / 2
-    // c2 = -(d+1) * d * (d-2) / 2
-    // c3 = (d+1) * d * (d-1) / 6
-
-    double d = frac;
-    double c0 = -d * (d - 1.0) * (d - 2.0) / 6.0;
-    double c1 = (d + 1.0) * (d - 1.0) * (d - 2.0) / 2.0;
-    double c2 = -(d + 1.0) * d * (d - 2.0) / 2.0;
-    double c3 = (d + 1.0) * d * (d - 1.0) / 6.0;
-
-    float delayed = (float)(c0 * y0 + c1 * y1 + c2 * y2 + c3 * y3);
-
-    float nextInput = input + delayed * feedback;
+      return;
+    int done = 0;
+    while (done < numSamples) {
+      // The glide ends once it is closer than this; from then on the time
+      // is constant and the spans below can be used
+      if (currentDelay != targetDelay &&
+          std::fabs(currentDelay - targetDelay) < 1e-3)
+        currentDelay = targetDelay;
+
+      const int remaining = numSamples - done;
+      if (currentDelay != targetDelay) {
+        done += processGliding(io + done, remaining);
+        continue;
+      }
+      const double whole = std::floor(currentDelay);
+      if (whole == currentDelay)
+        done += processWhole(io + done, remaining, (int)whole);
+      else
+        done += processFixed(io + done, remaining, (int)whole,
+                             (float)(1.0 - (currentDelay - whole)));
+    }
+  }
+
+private:
+  static constexpr int kMinDelay = 4; // room for the Lagrange taps
+  static constexpr int kChunk = 64;   // glide span
+
+  // Samples that can be written from writeIndex before the ring wraps and
+  // before a read reaches a sample written in the same span. reach: how far
+  // the newest tap sits ahead of the delayed position.
+  int spanLength(int remaining, int readBase, int delay, int reach) const {
+    const int size = mask + 1;
+    int n = std::min(remaining, delay - reach);
+    n = std::min(n, size - writeIndex);
+    n = std::min(n, size - (readBase + reach));
+    return n;
+  }
 
+  float feedbackInput(float input, float delayed) const {
     // Soft Clip Feedback to prevent explosion
-    if (nextInput > 2.0f)
-      nextInput = 2.0f;
-    if (nextInput < -2.0f)
-      nextInput = -2.0f;
-
-    buffer[writeIndex] = nextInput;
-    writeIndex++;
-    if (writeIndex >= buffer.size())
-      writeIndex = 0;
+    return flushDenormal(
+        std::max(-2.0f, std::min(2.0f, input + delayed * feedback)));
+  }
 
-    return input * (1.0 - mix) + delayed * mix;
+  // Whole-sample delay: the delayed span is contiguous in the ring
+  int processWhole(float *io, int remaining, int delay) {
+    const int readBase = (writeIndex - delay) & mask;
+    const int n = spanLength(remaining, readBase, delay, 0);
+    const float *delayed = buffer.data() + readBase;
+    float *write = buffer.data() + writeIndex;
+    const float dry = 1.0f - mix;
+    if (feedback == 0.0f) {
+      for (int i = 0; i < n; ++i) {
+        const float x = io[i];
+        io[i] = x * dry + delayed[i] * mix;
+        write[i] = flushDenormal(std::max(-2.0f, std::min(2.0f, x)));
+      }
+    } else {
+      for (int i = 0; i < n; ++i) {
+        const float x = io[i];
+        io[i] = x * dry + delayed[i] * mix;
+        write[i] = feedbackInput(x, delayed[i]);
+      }
+    }
+    writeIndex = (writeIndex + n) & mask;
+    return n;
+  }
+
+  // Constant fractional delay: one set of weights for the span, taps
+  // i - 1 .. i + 2 around the delayed position i + d
+  int processFixed(float *io, int remaining, int whole, float d) {
+    const int readBase = (writeIndex - whole - 1) & mask;
+    if (readBase == 0 || readBase + 2 > mask) {
+      // The taps straddle the end of the ring: one sample the long way
+      processOne(io, currentDelay);
+      return 1;
+    }
+    const int n = spanLength(remaining, readBase, whole + 1, 2);
+    const float c0 = -d * (d - 1.0f) * (d - 2.0f) / 6.0f;
+    const float c1 = (d + 1.0f) * (d - 1.0f) * (d - 2.0f) * 0.5f;
+    const float c2 = -(d + 1.0f) * d * (d - 2.0f) * 0.5f;
+    const float c3 = (d + 1.0f) * d * (d - 1.0f) / 6.0f;
+    const float *y = buffer.data() + readBase;
+    float *write = buffer.data() + writeIndex;
+    const float dry = 1.0f - mix;
+    for (int i = 0; i < n; ++i) {
+      const float delayed =
+          c0 * y[i - 1] + c1 * y[i] + c2 * y[i + 1] + c3 * y[i + 2];
+      const float x = io[i];
+      io[i] = x * dry + delayed * mix;
+      write[i] = feedbackInput(x, delayed);
+    }
+    writeIndex = (writeIndex + n) & mask;
+    return n;
+  }
+
+  // Gliding delay: the smoothed times of the span first (the recurrence),
+  // then the interpolation with masked taps
+  int processGliding(float *io, int remaining) {
+    const int n = std::min(remaining, (int)kChunk);
+    double delays[kChunk];
+    for (int i = 0; i < n; ++i) {
+      // Smooth delay time (Simple LPF on the delay time itself)
+      currentDelay = 0.999 * currentDelay + 0.001 * targetDelay;
+      delays[i] = currentDelay;
+    }
+    for (int i = 0; i < n; ++i)
+      processOne(io + i, delays[i]);
+    return n;
+  }
+
+  void processOne(float *io, double delay) {
+    const double readPos = (double)writeIndex - delay;
+    const double floorPos = std::floor(readPos);
+    const int i = (int)floorPos;
+    const float d = (float)(readPos - floorPos);
+    const float y0 = buffer[(i - 1) & mask];
+    const float y1 = buffer[i & mask];
+    const float y2 = buffer[(i + 1) & mask];
+    const float y3 = buffer[(i + 2) & mask];
+    const float delayed = -d * (d - 1.0f) * (d - 2.0f) / 6.0f * y0 +
+                          (d + 1.0f) * (d - 1.0f) * (d - 2.0f) * 0.5f * y1 -
+                          (d + 1.0f) * d * (d - 2.0f) * 0.5f * y2 +
+                          (d + 1.0f) * d * (d - 1.0f) / 6.0f * y3;
+    const float x = *io;
+    *io = x * (1.0f - mix) + delayed * mix;
+    buffer[writeIndex] = feedbackInput(x, delayed);
+    writeIndex = (writeIndex + 1) & mask;
   }
 
-private:
   std::vector<float> buffer;
+  int mask = 0;
   int writeIndex = 0;
+  double maxDelay = 0;
   double targetDelay = 0;
   double currentDelay = 0;
-  double feedback = 0, mix = 0;
+  float feedback = 0, mix = 0;
 };
 
 // --- Saturator ---
@@ -944,7 +1364,7 @@ public:
       else
         x = x - (x * x * x) / 3.0f;
     } else { // Hard Clip (Tube-ish / Fuzz)
-      x = std::tanh(x);
+      x = FastMath::tanh(x);
     }
 
     // 3. Post-Tone
@@ -959,85 +1379,282 @@ private:
   BiquadFilter mPostTone;
 };
 
-// --- Pitch Shifter (Granular) ---
+// --- Pitch Corrector (TD-PSOLA) ---
+// Retunes a monophonic voice to the nearest note of a scale and transposes
+// it. The f0 comes from outside (PitchDetector) through setPitch().
+//   Analysis: a pitch mark on the waveform peak near every period of the
+//   input (a fixed grid while unvoiced).
+//   Synthesis: two-period Hann grains around the nearest mark, overlap-added
+//   one target period apart, so the output repeats the voice's own pulses
+//   at the new rate with its formants in place.
+// The correction glides to the snapped note with the retune time. A grain
+// can need up to a period past its mark, which is why the output is delayed
+// by latency(); every buffer is allocated in initialize().
 class PitchShifter {
 public:
-  void setParameters(double amount, double speedPct, double sampleRate) {
-    double semitones = (amount - 50.0) / 50.0 * 12.0;
-    this->pitchRatio = pow(2.0, semitones / 12.0);
-    this->sampleRate = sampleRate;
+  static constexpr double kMinPitch = 70.0; // below this is unvoiced
+  static constexpr double kUnvoicedPitch = 200.0; // grain rate without f0
 
-    int bufSize = (int)(sampleRate * 0.2); // 200ms
-    if (buffer.size() != bufSize) {
-      buffer.resize(bufSize, 0);
-    }
+  struct Coefficients {
+    double transpose = 0.0;     // semitones
+    double retuneSamples = 0.0; // 0 snaps instantly
+    int scaleMask = 0xFFF;      // bit n: pitch class n (C = 0); 0 = no snap
+  };
 
-    // Map speed (0-100) to window size (100ms - 10ms)
-    // Slower Speed = Larger Window (Smoother)
-    // Faster Speed = Smaller Window (Choppy/Fast)
-    // 0 -> 100ms, 100 -> 10ms
-    double targetMs = 100.0 - (speedPct * 0.9);
-    if (targetMs < 10.0)
-      targetMs = 10.0;
+  enum Scale { Off, Chromatic, Major, Minor, Custom };
 
-    windowSize = (int)(sampleRate * targetMs / 1000.0);
-    if (windowSize > bufSize)
-      windowSize = bufSize;
+  // Output delay in samples
+  static int latency(double sampleRate) {
+    return 2 * (int)std::ceil(sampleRate / kMinPitch);
   }
 
-  float process(float input) {
-    if (buffer.empty())
-      return input;
+  void initialize(double sampleRate) {
+    this->sampleRate = sampleRate;
+    delay = latency(sampleRate);
+    int size = 1;
+    while (size < 3 * delay)
+      size <<= 1;
+    input.assign(size, 0.0f);
+    output.assign(size, 0.0f);
+    mask = size - 1;
+    reset();
+  }
 
-    buffer[writeIndex] = input;
+  void reset() {
+    std::fill(input.begin(), input.end(), 0.0f);
+    std::fill(output.begin(), output.end(), 0.0f);
+    inputTime = 0;
+    markFront = 0;
+    markCount = 1;
+    marks[0] = {0.0, sampleRate / kUnvoicedPitch};
+    nextGrain = 0.0;
+    voiced = false;
+    period = sampleRate / kUnvoicedPitch;
+    targetNote = -1;
+    targetShift = 0.0;
+    shift = 0.0;
+  }
 
-    double delay1 = phase;
-    double delay2 = phase + (windowSize / 2.0);
-    if (delay2 >= windowSize)
-      delay2 -= windowSize;
+  // amount: 0..100, 50 = no transpose, +-12 semitones at the ends.
+  // speedPct: 0..100, retune time 200 ms down to instant.
+  // key: 0..11 from C; scale: Scale; notes: Custom mask relative to the key
+  static Coefficients design(double amount, double speedPct, double key,
+                             double scale, double notes,
+                             double sampleRate) {
+    Coefficients c;
+    c.transpose = (amount - 50.0) / 50.0 * 12.0;
+    const double retuneMs = 200.0 * (1.0 - std::min(speedPct, 100.0) / 100.0);
+    c.retuneSamples = std::max(0.0, retuneMs) * 0.001 * sampleRate;
+
+    // Scale degrees relative to the key, rotated to absolute pitch classes
+    int relative = 0;
+    switch ((int)scale) {
+    case Chromatic:
+      relative = 0xFFF;
+      break;
+    case Major:
+      relative = 0xAB5; // 0 2 4 5 7 9 11
+      break;
+    case Minor:
+      relative = 0x5AD; // 0 2 3 5 7 8 10
+      break;
+    case Custom:
+      relative = ((int)notes & 0xFFF) ? (int)notes & 0xFFF : 0xFFF;
+      break;
+    default:
+      break;
+    }
+    const int k = std::max(0, std::min(11, (int)key));
+    c.scaleMask = ((relative << k) | (relative >> (12 - k))) & 0xFFF;
+    return c;
+  }
 
-    float out1 = readBuffer(delay1);
-    float out2 = readBuffer(delay2);
+  void setCoefficients(const Coefficients &c) {
+    const bool maskChanged = c.scaleMask != scaleMask;
+    transpose = c.transpose;
+    retuneSamples = c.retuneSamples;
+    scaleMask = c.scaleMask;
+    if (maskChanged)
+      targetNote = -1;
+  }
 
-    float env1 = 1.0f - fabs(2.0f * (float)phase / windowSize - 1.0f);
+  // Latest f0 estimate in Hz, 0 while unvoiced
+  void setPitch(float f0) {
+    voiced = f0 >= kMinPitch;
+    if (!voiced) {
+      targetShift = 0.0;
+      return;
+    }
+    period = sampleRate / f0;
+    if (scaleMask == 0) {
+      targetShift = 0.0;
+      return;
+    }
+    const double note = 69.0 + 12.0 * std::log2(f0 / 440.0);
+    targetNote = snap(note);
+    targetShift = targetNote - note;
+  }
 
-    float output = out1 * env1 + out2 * (1.0f - env1);
+  float process(float x) {
+    input[inputTime & mask] = x;
+    ++inputTime;
+
+    // Next analysis mark, once the samples around it have arrived
+    const Mark &last = marks[(markFront + markCount - 1) & (kMaxMarks - 1)];
+    const double analysisPeriod = voiced ? period : sampleRate / kUnvoicedPitch;
+    const int64_t centre = (int64_t)std::lround(last.time + analysisPeriod);
+    const int reach = voiced ? (int)(analysisPeriod * 0.25) : 0;
+    if (inputTime > centre + reach)
+      addMark(centre, reach, analysisPeriod);
+
+    // Grains whose window has reached the output
+    const int64_t readTime = inputTime - delay;
+    while (nextGrain - marks[markFront].period <= (double)readTime)
+      addGrain(readTime);
+
+    float &slot = output[readTime & mask];
+    const float y = slot;
+    slot = 0.0f;
+    return y;
+  }
 
-    phase += (1.0 - pitchRatio);
-    if (phase >= windowSize)
-      phase -= windowSize;
-    if (phase < 0)
-      phase += windowSize;
+  void processBlock(float *buffer, int numSamples) {
+    for (int i = 0; i < numSamples; ++i)
+      buffer[i] = process(buffer[i]);
+  }
 
-    writeIndex++;
-    if (writeIndex >= buffer.size())
-      writeIndex = 0;
+private:
+  static constexpr int kMaxMarks = 256; // power of two
+  // Semitones the snapped note holds on past the midpoint to the next one
+  static constexpr double kHysteresis = 0.15;
+
+  struct Mark {
+    double time; // samples since reset
+    double period;
+  };
+
+  // Nearest allowed note, staying on the current one near a boundary
+  int snap(double note) const {
+    const int base = (int)std::lround(note);
+    int best = base;
+    double bestDistance = 1e9;
+    for (int d = -6; d <= 6; ++d) {
+      const int candidate = base + d;
+      const double distance = std::fabs(candidate - note);
+      if (allowed(candidate) && distance < bestDistance) {
+        best = candidate;
+        bestDistance = distance;
+      }
+    }
+    if (targetNote >= 0 && allowed(targetNote) &&
+        std::fabs(targetNote - note) < bestDistance + kHysteresis)
+      return targetNote;
+    return best;
+  }
 
-    return output;
+  bool allowed(int note) const { return (scaleMask >> (note % 12)) & 1; }
+
+  void addMark(int64_t centre, int reach, double markPeriod) {
+    // Voiced marks sit on the largest sample near one period on, so each
+    // grain is centred on a pulse, refined between samples with a parabola
+    // so the marks do not jitter by half a sample
+    int64_t peakTime = centre;
+    float peak = input[centre & mask];
+    for (int64_t t = centre - reach; t <= centre + reach; ++t) {
+      if (input[t & mask] > peak) {
+        peak = input[t & mask];
+        peakTime = t;
+      }
+    }
+    double time = (double)peakTime;
+    if (reach > 0 && peakTime > centre - reach && peakTime < centre + reach) {
+      const float a = input[(peakTime - 1) & mask];
+      const float c = input[(peakTime + 1) & mask];
+      const float denom = a - 2.0f * peak + c;
+      if (denom < 0.0f)
+        time += 0.5 * (a - c) / denom;
+    }
+    if (markCount == kMaxMarks) {
+      markFront = (markFront + 1) & (kMaxMarks - 1);
+      --markCount;
+    }
+    marks[(markFront + markCount) & (kMaxMarks - 1)] = {time, markPeriod};
+    ++markCount;
   }
 
-private:
-  float readBuffer(double delaySamples) {
-    double readPos = writeIndex - delaySamples;
-    while (readPos < 0)
-      readPos += buffer.size();
-    while (readPos >= buffer.size())
-      readPos -= buffer.size();
+  // Overlap-adds the grain for the synthesis mark nextGrain and steps to the
+  // next one
+  void addGrain(int64_t readTime) {
+    // Marks behind the newest one at or before the grain are done with
+    while (markCount > 1 &&
+           marks[(markFront + 1) & (kMaxMarks - 1)].time <= nextGrain) {
+      markFront = (markFront + 1) & (kMaxMarks - 1);
+      --markCount;
+    }
+    Mark mark = marks[markFront];
+    if (markCount > 1) {
+      const Mark &next = marks[(markFront + 1) & (kMaxMarks - 1)];
+      if (next.time + next.period + 1.0 <= (double)inputTime &&
+          next.time - nextGrain < nextGrain - mark.time)
+        mark = next;
+    }
 
-    int i = (int)readPos;
-    double f = readPos - i;
-    int i2 = i + 1;
-    if (i2 >= buffer.size())
-      i2 = 0;
+    // Hann over +-T around nextGrain, read +-T around the mark
+    const double T = mark.period;
+    const int64_t first = std::max(readTime, (int64_t)std::ceil(nextGrain - T));
+    const int64_t last = (int64_t)std::floor(nextGrain + T);
+    // The source sits a fixed fraction between samples for the whole grain:
+    // one set of cubic Lagrange weights covers it
+    const double offset = mark.time - nextGrain;
+    const int64_t shiftWhole = (int64_t)std::floor(offset);
+    const float d = (float)(offset - (double)shiftWhole);
+    const float h0 = -d * (d - 1.0f) * (d - 2.0f) / 6.0f;
+    const float h1 = (d + 1.0f) * (d - 1.0f) * (d - 2.0f) * 0.5f;
+    const float h2 = -(d + 1.0f) * d * (d - 2.0f) * 0.5f;
+    const float h3 = (d + 1.0f) * d * (d - 1.0f) / 6.0f;
+    const double step = kPi / T;
+    double phase = ((double)first - nextGrain) * step;
+    double wc = std::cos(phase), ws = std::sin(phase);
+    const double rc = std::cos(step), rs = std::sin(step);
+    for (int64_t p = first; p <= last; ++p) {
+      const int64_t i = p + shiftWhole;
+      const float x = h0 * input[(i - 1) & mask] + h1 * input[i & mask] +
+                      h2 * input[(i + 1) & mask] + h3 * input[(i + 2) & mask];
+      output[p & mask] += x * (float)(0.5 + 0.5 * wc);
+      const double c = wc * rc - ws * rs;
+      ws = ws * rc + wc * rs;
+      wc = c;
+    }
 
-    return buffer[i] * (1.0 - f) + buffer[i2] * f;
+    // Glide toward the snapped note, then place the next grain one target
+    // period on
+    const double hop = T / std::pow(2.0, (shift + transpose) / 12.0);
+    if (retuneSamples > 0.0)
+      shift += (targetShift - shift) * (1.0 - std::exp(-hop / retuneSamples));
+    else
+      shift = targetShift;
+    nextGrain += T / std::pow(2.0, (shift + transpose) / 12.0);
   }
 
-  std::vector<float> buffer;
-  int writeIndex = 0;
-  double phase = 0;
-  int windowSize = 0;
-  double pitchRatio = 1.0;
+  std::vector<float> input;
+  std::vector<float> output; // overlap-add accumulator, read at readTime
+  int64_t mask = 0;
+  int64_t inputTime = 0;
+  int delay = 0;
+
+  Mark marks[kMaxMarks];
+  int markFront = 0, markCount = 0;
+  double nextGrain = 0.0;
+
+  bool voiced = false;
+  double period = 220.5;
+  int targetNote = -1;
+  double targetShift = 0.0;
+  double shift = 0.0;
+
+  double transpose = 0.0;
+  double retuneSamples = 0.0;
+  int scaleMask = 0xFFF;
   double sampleRate = 44100;
 };
 
@@ -1047,37 +1664,53 @@ private:
 // preservation. Prime number delay lengths prevent resonant modes.
 class FDNReverb {
 public:
-  FDNReverb() {
-    // Prime number delays for 44.1kHz (approx 25ms to 90ms)
-    // Scaled by size parameter later.
-    baseDelays = {1117, 1361, 1613, 1933, 2273, 2663, 3167, 3943};
-
-    delayLines.resize(8);
-    // Buffer size generous enough for modulation
-    for (int i = 0; i < 8; i++) {
-      delayLines[i].resize(8192, 0); // ~180ms max
-    }
-
-    // Feedback buffer
-    feedbackBuffer.resize(8, 0.0f);
-    outputs.resize(8, 0.0f);
-
-    // LowPass states for damping
-    lpStates.resize(8, 0.0f);
+  static constexpr int kLines = 8;
+  static constexpr int kLineLength = 8192; // ~180ms max, power of two
+
+  FDNReverb() { initialize(); }
+
+  // Allocates and clears the delay arena. Not real-time safe.
+  // rateDivider: the network runs at the sample rate / rateDivider (1, 2
+  // or 4), which shortens the lines by the same factor.
+  void initialize(int rateDivider = 1) {
+    lineLength = kLineLength / rateDivider;
+    lineMask = lineLength - 1;
+    // All lines live back to back in one arena, its base on a cache line
+    arena.assign(kLines * lineLength + kAlignFloats, 0.0f);
+    const size_t misalign = (size_t)arena.data() % 64;
+    baseOffset = misalign ? (int)((64 - misalign) / sizeof(float)) : 0;
+    writePos = 0;
+    std::fill(lpStates, lpStates + kLines, 0.0f);
   }
 
-  void setParameters(double size, double damp, double mix, double sampleRate) {
-    this->mix = mix / 100.0;
+  struct Coefficients {
+    int delays[8] = {0};
+    float feedbackGain = 0.5f;
+    float dampCoef = 0.0f;
+    float mix = 0.0f;
+  };
+
+  // rateDivider must match the one passed to initialize(). The delays
+  // shrink and the damping pole is mapped to the lower rate, so the tail
+  // keeps its decay time and brightness.
+  static Coefficients design(double size, double damp, double mix,
+                             double sampleRate, int rateDivider = 1) {
+    // Prime number delays for 44.1kHz (approx 25ms to 90ms)
+    static const int kBaseDelays[8] = {1117, 1361, 1613, 1933,
+                                       2273, 2663, 3167, 3943};
+    Coefficients c;
+    c.mix = mix / 100.0;
 
     // Size scales the delay lines
     // size 0-100. 50 is nominal.
     double sizeFactor = 0.5 + (size / 100.0); // 0.5x to 1.5x
 
+    const int maxDelay = kLineLength / rateDivider - 1;
     for (int i = 0; i < 8; i++) {
-      currentDelays[i] = (int)(baseDelays[i] * sizeFactor);
+      c.delays[i] = (int)(kBaseDelays[i] * sizeFactor / rateDivider);
       // Safety clamp
-      if (currentDelays[i] >= 8192)
-        currentDelays[i] = 8191;
+      if (c.delays[i] > maxDelay)
+        c.delays[i] = maxDelay;
     }
 
     // Damping (LowPass in feedback)
@@ -1085,7 +1718,9 @@ public:
     // simple one-pole coef: y = x + coef * (last_y - x) -> y = x(1-c) + last*c
     // ? Or y = y + c * (x - y) Higher damp = lower cutoff = higher coef (if
     // coef 0 is no filtering) 0 -> 0.0 (open) 100 -> 0.4 (quite muffled loops)
-    this->dampCoef = damp / 250.0;
+    c.dampCoef = damp / 250.0;
+    // Same cutoff in Hz at the lower rate: the pole moves to d^divider
+    c.dampCoef = std::pow(c.dampCoef, (float)rateDivider);
 
     // RT60 roughly controlled by feedback gain
     // T60 = -3 * Delay / log(gain)
@@ -1102,288 +1737,530 @@ public:
     // decay.
 
     // Map size (0-100) to feedback (0.8 to 0.99)
-    this->feedbackGain = 0.80 + (size / 100.0) * 0.19;
+    c.feedbackGain = 0.80 + (size / 100.0) * 0.19;
+    return c;
   }
 
-  float process(float input) {
-    // 1. Input into all delay lines
-    // 2. Read from delay lines
-    // 3. Hadamard Mix
-    // 4. Feedback with Damping
+  void setCoefficients(const Coefficients &c) {
+    std::copy_n(c.delays, 8, currentDelays);
+    feedbackGain = c.feedbackGain;
+    dampCoef = c.dampCoef;
+    mix = c.mix;
+  }
 
-    float outSum = 0.0f;
+  void setParameters(double size, double damp, double mix, double sampleRate) {
+    setCoefficients(design(size, damp, mix, sampleRate));
+  }
 
-    for (int i = 0; i < 8; i++) {
-      // Read ptr
-      int readIdx = indices[i] - currentDelays[i];
-      if (readIdx < 0)
-        readIdx += delayLines[i].size();
-
-      float delayed = delayLines[i][readIdx];
-      outputs[i] = delayed;
-      outSum += delayed;
-    }
+  // Network-rate samples the tail rings on after the input stops. The
+  // Hadamard mix is unitary and the damping has unity gain at DC, so the
+  // slowest decay is the feedback gain per pass of the longest line.
+  static double tailSamples(const Coefficients &c) {
+    const int longest = *std::max_element(c.delays, c.delays + kLines);
+    return longest * decayPasses(c.feedbackGain);
+  }
 
-    // Hadamard Matrix 8x8 Fast Transform
-    // Recursive structure:
-    // H1 = [1]
-    // H2 = [1 1; 1 -1]
-    // ...
-    // Standard unnormalized Hadamard creates gain of sqrt(8). We must normalize
-    // by 1/sqrt(8).
-
-    // Copy outputs to temp for matrix op
-    float h[8];
-    for (int i = 0; i < 8; i++)
-      h[i] = outputs[i];
-
-    // Fast Walsh-Hadamard Transform logic for 8 elements
-    // Stage 1
-    // 0+1, 0-1, 2+3, 2-3...
-    float s1[8];
-    for (int i = 0; i < 8; i += 2) {
-      s1[i] = h[i] + h[i + 1];
-      s1[i + 1] = h[i] - h[i + 1];
-    }
+  // Mono: the input feeds every line, the output is the sum of all lines
+  void process(const float *input, float *output, int numSamples) {
+    render<false>(input, input, output, output, numSamples);
+  }
 
-    // Stage 2
-    // 0+2, 1+3, 0-2, 1-3... (group 4)
-    // Actually standard butterfly:
-    // For size 4:
-    // S2[0] = S1[0] + S1[2]
-    // S2[1] = S1[1] + S1[3]
-    // S2[2] = S1[0] - S1[2]
-    // S2[3] = S1[1] - S1[3]
-    // Same for 4-7
-    float s2[8];
-    for (int offset = 0; offset < 8; offset += 4) {
-      s2[offset + 0] = s1[offset + 0] + s1[offset + 2];
-      s2[offset + 1] = s1[offset + 1] + s1[offset + 3];
-      s2[offset + 2] = s1[offset + 0] - s1[offset + 2];
-      s2[offset + 3] = s1[offset + 1] - s1[offset + 3];
-    }
+  // True stereo, one network for both channels: L feeds the even lines and
+  // R the odd ones, and the outputs are tapped from the same split. The
+  // Hadamard mix spreads every input over every line, so each side hears
+  // the whole tail, decorrelated by the different line lengths.
+  void process(const float *inputL, const float *inputR, float *outputL,
+               float *outputR, int numSamples) {
+    render<true>(inputL, inputR, outputL, outputR, numSamples);
+  }
 
-    // Stage 3 (Final for 8)
-    float s3[8]; // Result
-    for (int i = 0; i < 4; i++) {
-      s3[i] = s2[i] + s2[i + 4];
-      s3[i + 4] = s2[i] - s2[i + 4];
-    }
+  void processBlock(float *buffer, int numSamples) {
+    process(buffer, buffer, numSamples);
+  }
 
-    // Normalize (1/sqrt(8) approx 0.3535)
-    float norm = 0.35355f;
+private:
+  // Slack for moving the arena base onto a 64-byte boundary
+  static constexpr int kAlignFloats = 64 / sizeof(float);
+
+  // Every line shares one write position, so reads and writes wrap with a
+  // mask. Per sample the lines are a vector of 8: the Hadamard butterflies
+  // work on contiguous halves (4-wide adds / subtracts) and the damping and
+  // feedback run as one pass across all lines, so both map onto SIMD lanes.
+  template <bool Stereo>
+  void render(const float *inputL, const float *inputR, float *outputL,
+              float *outputR, int numSamples) {
+    float *lines = arena.data() + baseOffset;
+    const float dry = 1.0f - mix;
+    // Normalize sum output: over all 8 lines, or 4 per side
+    const float wet = (Stereo ? 0.25f : 0.125f) * mix;
+    const float damp = dampCoef;
+    const float pass = 1.0f - dampCoef;
+    const float fb = feedbackGain;
+    // Filter state in a local: the arena stores cannot alias it, so it
+    // stays in registers
+    float lp[kLines];
+    std::copy(lpStates, lpStates + kLines, lp);
+
+    for (int n = 0; n < numSamples; ++n) {
+      const float inL = inputL[n];
+      const float inR = inputR[n];
+
+      // 1. Read from delay lines
+      float taps[kLines];
+      float sumEven = 0.0f, sumOdd = 0.0f;
+      for (int i = 0; i < kLines; ++i)
+        taps[i] =
+            lines[i * lineLength + ((writePos - currentDelays[i]) & lineMask)];
+      for (int i = 0; i < kLines; i += 2) {
+        sumEven += taps[i];
+        sumOdd += taps[i + 1];
+      }
 
-    // Feedback Loop
-    for (int i = 0; i < 8; i++) {
-      float mixed = s3[i] * norm;
+      // 2. Hadamard Mix
+      // Fast Walsh-Hadamard Transform, widest butterfly first (the stages
+      // commute): 0+4, 0-4 ... then 0+2, 0-2 ... then 0+1, 0-1 ...
+      // Unnormalized it has a gain of sqrt(8), so scale by 1/sqrt(8).
+      float s[kLines];
+      float mixed[kLines];
+      for (int i = 0; i < 4; ++i) {
+        s[i] = taps[i] + taps[i + 4];
+        s[i + 4] = taps[i] - taps[i + 4];
+      }
+      for (int offset = 0; offset < kLines; offset += 4)
+        for (int i = offset; i < offset + 2; ++i) {
+          taps[i] = s[i] + s[i + 2];
+          taps[i + 2] = s[i] - s[i + 2];
+        }
+      for (int i = 0; i < kLines; i += 2) {
+        s[i] = taps[i] + taps[i + 1];
+        s[i + 1] = taps[i] - taps[i + 1];
+      }
+      for (int j = 0; j < kLines; ++j)
+        mixed[j] = s[j] * 0.35355f;
 
-      // Damping (One-pole LowPass)
+      // 3. Feedback with Damping (One-pole LowPass)
       // y[n] = x[n] * (1-d) + y[n-1] * d
-      lpStates[i] = mixed * (1.0 - dampCoef) + lpStates[i] * dampCoef;
-      float damped = lpStates[i];
-
-      // Sum Input + Feedback
-      // Input injected into all lines (or specific ones?)
-      // Standard FDN: Input + Feedback -> Delay
-      float next = input + damped * feedbackGain;
-
-      // Soft clip safety
-      if (next > 2.0f)
-        next = 2.0f;
-      else if (next < -2.0f)
-        next = -2.0f;
-
-      // Write
-      delayLines[i][indices[i]] = next;
-
-      // Advance ptr
-      indices[i]++;
-      if (indices[i] >= delayLines[i].size())
-        indices[i] = 0;
-    }
+      // Input injected into the lines, soft clip safety at +-2
+      for (int j = 0; j < kLines; ++j) {
+        lp[j] = flushDenormal(mixed[j] * pass + lp[j] * damp);
+        const float next = ((j & 1) ? inR : inL) + lp[j] * fb;
+        lines[j * lineLength + writePos] =
+            std::max(-2.0f, std::min(next, 2.0f));
+      }
+      writePos = (writePos + 1) & lineMask;
 
-    return input * (1.0f - mix) + outSum * 0.125f * mix; // Normalize sum output
+      if (Stereo) {
+        outputL[n] = inL * dry + sumEven * wet;
+        outputR[n] = inR * dry + sumOdd * wet;
+      } else {
+        outputL[n] = inL * dry + (sumEven + sumOdd) * wet;
+      }
+    }
+    std::copy(lp, lp + kLines, lpStates);
   }
 
-private:
-  std::vector<int> baseDelays;
   int currentDelays[8] = {0};
-  std::vector<std::vector<float>> delayLines;
-  std::vector<int> indices = std::vector<int>(8, 0);
+  std::vector<float> arena;
+  int lineLength = kLineLength;
+  int lineMask = kLineLength - 1;
+  int baseOffset = 0;
+  int writePos = 0;
 
-  std::vector<float> feedbackBuffer;
-  std::vector<float> outputs;
-  std::vector<float> lpStates;
+  float lpStates[kLines] = {0};
 
   float feedbackGain = 0.5f;
   float dampCoef = 0.0f;
   float mix = 0.0f;
 };
 
-// --- Oversampler (4x Linear Phase FIR) ---
-class Oversampler {
+// --- Half-Band Stage (2x Polyphase FIR) ---
+// A linear phase half-band lowpass has every other tap equal to zero except
+// the centre tap (0.5). Split into its two polyphase branches, one branch is
+// a short dense FIR and the other is a pure delay, so a 2x resampler costs
+// one dense dot product per low-rate sample instead of the full filter.
+// History is kept in linear (non-wrapping) buffers so the dot product reads
+// a contiguous window and the tap loop maps onto SIMD lanes.
+class HalfBandStage {
 public:
-  Oversampler() { reset(); }
-
-  void initialize() {
-    generateCoeffs();
+  // No out-of-line definitions (C++14): copy them, e.g. (int)kChunk, before
+  // binding them to a reference such as std::min's parameters.
+  static constexpr int kMaxTaps = 32; // dense taps per branch
+  static constexpr int kChunk = 256;  // low-rate samples per inner pass
+
+  // denseTaps: non-zero taps in the dense branch (multiple of 4).
+  // Full filter length is 2 * denseTaps - 1.
+  void initialize(int denseTaps, double kaiserBeta) {
+    taps = std::max(4, std::min((int)kMaxTaps, denseTaps & ~3));
+    generateCoeffs(kaiserBeta);
     reset();
   }
 
   void reset() {
-    std::fill(upBuffer.begin(), upBuffer.end(), 0.0f);
-    std::fill(downBuffer.begin(), downBuffer.end(), 0.0f);
-    upMbIndex = 0;
-    downMbIndex = 0;
-  }
-
-  // Upsample: 1 input -> 4 outputs
-  // Writes 4 samples to 'output' array
-  void processUpsample(float input, float *output) {
-    // 1. Insert input into circular buffer (Zero Stuffing logic implicit in
-    // polyphase) Standard FIR: Upsampling means inserting 3 zeros between
-    // samples. The LowPass filter is applied to this sparse stream. Polyphase
-    // efficient method: output[0] = input * h[0] + hist[0]*h[4] + ... output[1]
-    // = input * h[1] + hist[0]*h[5] + ... But here we use a simple sliding
-    // window for robustness.
-
-    // Push input
-    upBuffer[upMbIndex] = input;
-
-    // Convolve for 4 phases
-    // Phase p (0..3): corresponds to fractional delay
-    // We need to maintain state. The buffer stores *input* samples (at 1x
-    // rate). Each output sample is a dot product of the input buffer and a
-    // subset of coeffs.
-
-    // Coeff index mapping for 4x upsampling:
-    // h has length 64.
-    // y[0] = sum(x[n-k] * h[4k])
-    // y[1] = sum(x[n-k] * h[4k + 1])
-    // ...
-
-    int bufSize = (int)upBuffer.size();
-
-    for (int phase = 0; phase < 4; ++phase) {
-      double sum = 0.0;
-      // Dot product
-      int tapIndex = phase;
-      // We iterate taps with stride 4
-      // x[n] is at mbIndex. x[n-1] is at mbIndex-1...
-
-      for (int k = 0; k < 16; ++k) { // 64 taps / 4 = 16 taps per phase
-        int bufIdx = upMbIndex - k;
-        if (bufIdx < 0)
-          bufIdx += bufSize;
-
-        sum += upBuffer[bufIdx] * coeffs[tapIndex];
-        tapIndex += 4;
+    std::fill(upHistory, upHistory + kMaxTaps + kChunk, 0.0f);
+    std::fill(downEven, downEven + kMaxTaps + kChunk, 0.0f);
+    std::fill(downOdd, downOdd + kMaxTaps + kChunk, 0.0f);
+  }
+
+  // 2x upsample: numSamples inputs -> 2 * numSamples outputs
+  void upsample(const float *input, float *output, int numSamples) {
+    const int hist = taps - 1;
+    const int centre = taps / 2; // pure-delay branch read offset
+
+    while (numSamples > 0) {
+      const int n = std::min(numSamples, (int)kChunk);
+      std::copy_n(input, n, upHistory + hist);
+
+      for (int i = 0; i < n; ++i) {
+        output[2 * i] = dot(upCoeffs, upHistory + i, taps);
+        output[2 * i + 1] = upHistory[i + centre];
       }
-      // Gain correction for upsampling (x4 energy loss in zero stuffing)
-      // Ideally filter has gain 4.0. We normalize coeffs to unity sum, so
-      // multiply by 4.
-      output[phase] = (float)(sum * 4.0);
-    }
 
-    // Advance buffer
-    upMbIndex++;
-    if (upMbIndex >= bufSize)
-      upMbIndex = 0;
+      std::copy_n(upHistory + n, hist, upHistory);
+      input += n;
+      output += 2 * n;
+      numSamples -= n;
+    }
   }
 
-  // Downsample: 4 inputs -> 1 output
-  float processDownsample(const float *input) {
-    // Push 4 samples into downsample buffer
-    // Then apply LPF and take every 4th sample (Decimate)
-    // Optimization: We only need to compute 1 output sample for every 4 inputs.
-    // So we only compute the convolution when we align.
+  // 2x downsample: 2 * numSamples inputs -> numSamples outputs
+  void downsample(const float *input, float *output, int numSamples) {
+    const int hist = taps - 1;
+    const int delay = taps / 2; // centre tap lag on the odd branch
+
+    while (numSamples > 0) {
+      const int n = std::min(numSamples, (int)kChunk);
+      for (int i = 0; i < n; ++i) {
+        downEven[hist + i] = input[2 * i];
+        downOdd[hist + i] = input[2 * i + 1];
+      }
+
+      for (int i = 0; i < n; ++i) {
+        output[i] = dot(downCoeffs, downEven + i, taps) +
+                    0.5f * downOdd[i + hist - delay];
+      }
+
+      std::copy_n(downEven + n, hist, downEven);
+      std::copy_n(downOdd + n, hist, downOdd);
+      input += 2 * n;
+      output += n;
+      numSamples -= n;
+    }
+  }
 
-    // Robust Implementation:
-    // Treat as sliding buffer. Push 4. Compute 1 dot product.
+  // Round trip (up + down) delay in samples at this stage's low rate.
+  // Group delay is (taps - 1) high-rate samples on each side.
+  double getLatency() const { return (double)(taps - 1); }
 
-    int bufSize = (int)downBuffer.size();
+private:
+  // Four independent accumulators so the tap loop vectorizes without
+  // relying on fast-math reassociation. n is a multiple of 4.
+  static inline float dot(const float *c, const float *x, int n) {
+    float s0 = 0.0f, s1 = 0.0f, s2 = 0.0f, s3 = 0.0f;
+    for (int j = 0; j < n; j += 4) {
+      s0 += c[j] * x[j];
+      s1 += c[j + 1] * x[j + 1];
+      s2 += c[j + 2] * x[j + 2];
+      s3 += c[j + 3] * x[j + 3];
+    }
+    return (s0 + s1) + (s2 + s3);
+  }
 
-    for (int i = 0; i < 4; ++i) {
-      downBuffer[downMbIndex] = input[i];
-      downMbIndex++;
-      if (downMbIndex >= bufSize)
-        downMbIndex = 0;
+  static double besselI0(double x) {
+    double sum = 1.0, term = 1.0;
+    for (int k = 1; k < 32; ++k) {
+      term *= (x / (2.0 * k)) * (x / (2.0 * k));
+      sum += term;
     }
+    return sum;
+  }
+
+  void generateCoeffs(double beta) {
+    // Kaiser windowed sinc, cutoff at a quarter of the high rate.
+    // Full length N = 2 * taps - 1, centre index taps - 1 (odd), so the
+    // even-index taps form the dense branch.
+    const int N = 2 * taps - 1;
+    const double centre = taps - 1;
+    const double i0Beta = besselI0(beta);
 
-    // Compute Convolution at current point
-    // Using all 64 taps on the high-rate buffer.
+    double dense[kMaxTaps];
     double sum = 0.0;
-    int readIdx = downMbIndex - 1; // Latest sample
+    for (int j = 0; j < taps; ++j) {
+      double n = 2.0 * j - centre; // always odd, never zero
+      double h = std::sin(0.5 * kPi * n) / (kPi * n);
+      double r = n / (N - 1) * 2.0;
+      double w = besselI0(beta * std::sqrt(std::max(0.0, 1.0 - r * r))) / i0Beta;
+      dense[j] = h * w;
+      sum += dense[j];
+    }
 
-    for (int k = 0; k < 64; ++k) {
-      if (readIdx < 0)
-        readIdx += bufSize;
-      sum += downBuffer[readIdx] * coeffs[k];
-      readIdx--;
+    // Normalize the dense branch to 0.5 so DC gain of the full filter is 1
+    for (int j = 0; j < taps; ++j) {
+      double c = dense[j] * 0.5 / sum;
+      // Symmetric filter: reversed order equals forward order
+      downCoeffs[j] = (float)c;
+      upCoeffs[j] = (float)(2.0 * c); // zero-stuffing gain
     }
+  }
+
+  int taps = 16;
+  float upCoeffs[kMaxTaps] = {0};
+  float downCoeffs[kMaxTaps] = {0};
 
-    return (float)sum;
+  // Linear histories: [taps - 1 previous samples | current chunk]
+  float upHistory[kMaxTaps + kChunk];
+  float downEven[kMaxTaps + kChunk];
+  float downOdd[kMaxTaps + kChunk];
+};
+
+// --- Oversampler (1x/2x/4x/8x, Cascaded Half-Band) ---
+// Up to three 2x half-band stages: a steep one between 1x and 2x where the
+// transition band is narrow, and short ones above that where the images
+// sit far above the base band. Factor 1 is a plain copy with no latency.
+class Oversampler {
+public:
+  static constexpr int kMaxStages = 3;
+  static constexpr int kMaxFactor = 1 << kMaxStages;
+  static constexpr int kBlock = 64; // 1x samples per pass
+
+  Oversampler() { initialize(); }
+
+  void initialize() { initialize(16, 8); }
+
+  // Dense taps of the 1x <-> 2x stage and of the stages above it. Shorter
+  // filters trade stopband depth and transition width for CPU.
+  void initialize(int firstStageTaps, int upperStageTaps) {
+    mStages[0].initialize(firstStageTaps, 8.0); // 1x <-> 2x
+    mStages[1].initialize(upperStageTaps, 8.0); // 2x <-> 4x
+    mStages[2].initialize(upperStageTaps, 8.0); // 4x <-> 8x
+    reset();
   }
 
-  int getLatency() {
-    // Linear Phase Latency = Taps / 2.
-    // Upsampler: 64 taps (at 4x rate) -> latency is 32 samples at 4x rate = 8
-    // samples at 1x rate. Downsampler: 64 taps (at 4x rate) -> latency is 32
-    // samples at 4x rate = 8 samples at 1x rate. Total RTT latency = 16 samples
-    // at 1x rate.
-    return 16;
+  void reset() {
+    for (auto &stage : mStages)
+      stage.reset();
   }
 
-private:
-  void generateCoeffs() {
-    // Windowed Sinc
-    // Cutoff = 0.25 (Nyquist/4).
-    // Length = 64. Center = 31.5.
-    // But for delay integer alignment, let's prefer odd length?
-    // 64 is fine for polyphase.
-
-    double fc = 0.25;
-    int N = 64;
-
-    for (int i = 0; i < N; ++i) {
-      double n = i - (N - 1.0) / 2.0;
-      // Sinc
-      double h = 0.0;
-      if (fabs(n) < 1e-9) {
-        h = 2.0 * kPi * fc;
-      } else {
-        h = sin(2.0 * kPi * fc * n) / (kPi * n);
+  // factor: 1, 2, 4 or 8. Clears the stage histories.
+  void setFactor(int factor) {
+    int stages = 0;
+    while ((1 << stages) < factor && stages < kMaxStages)
+      ++stages;
+    mNumStages = stages;
+    reset();
+  }
+
+  int getFactor() const { return 1 << mNumStages; }
+
+  // Upsample: numSamples inputs -> factor * numSamples outputs
+  void upsample(const float *input, float *output, int numSamples) {
+    if (mNumStages == 0) {
+      std::copy_n(input, numSamples, output);
+      return;
+    }
+
+    while (numSamples > 0) {
+      const int n = std::min(numSamples, (int)kBlock);
+      const float *src = input;
+      for (int s = 0; s < mNumStages; ++s) {
+        float *dst = (s == mNumStages - 1) ? output : mMid[s & 1];
+        mStages[s].upsample(src, dst, n << s);
+        src = dst;
       }
-      // Normalized Sinc (sin(pi*x)/(pi*x)) uses fc in [0, 0.5]?
-      // Formula: 2*fc * sinc(2*fc*n)?
-      // Let's use standard: sin(2*pi*fc*n) / (pi*n) is correct for fc in [0,
-      // 0.5].
-
-      // Blackman Window
-      double w = 0.42 - 0.5 * cos(2.0 * kPi * i / (N - 1)) +
-                 0.08 * cos(4.0 * kPi * i / (N - 1));
-      coeffs[i] = h * w;
+      input += n;
+      output += n << mNumStages;
+      numSamples -= n;
     }
+  }
 
-    // Normalize gain to 1.0 (at DC)
-    double sum = 0.0;
-    for (double c : coeffs)
-      sum += c;
-    for (double &c : coeffs)
-      c /= sum;
+  // Downsample: factor * numSamples inputs -> numSamples outputs
+  void downsample(const float *input, float *output, int numSamples) {
+    if (mNumStages == 0) {
+      std::copy_n(input, numSamples, output);
+      return;
+    }
+
+    while (numSamples > 0) {
+      const int n = std::min(numSamples, (int)kBlock);
+      const float *src = input;
+      for (int s = mNumStages - 1; s >= 0; --s) {
+        float *dst = (s == 0) ? output : mMid[s & 1];
+        mStages[s].downsample(src, dst, n << s);
+        src = dst;
+      }
+      input += n << mNumStages;
+      output += n;
+      numSamples -= n;
+    }
+  }
+
+  // Round trip latency in samples at 1x rate.
+  // Each stage reports at its own low rate, 2^s times the base rate.
+  double getLatency() const { return getLatency(getFactor()); }
+
+  // Latency the cascade would have at another factor (the stage designs are
+  // fixed, so this is safe to call from any thread)
+  double getLatency(int factor) const {
+    double latency = 0.0;
+    for (int s = 0; s < kMaxStages && (2 << s) <= factor; ++s)
+      latency += mStages[s].getLatency() / (double)(1 << s);
+    return latency;
+  }
+
+private:
+  HalfBandStage mStages[kMaxStages];
+  int mNumStages = 2;
+  float mMid[2][kBlock * kMaxFactor / 2];
+};
+
+// --- Multirate Reverb ---
+// Damped reverb tails carry almost nothing in the top octave, so at high
+// session rates the FDN runs at fs/2 or fs/4 between half-band decimators
+// and interpolators (the Oversampler cascade, used the other way round).
+// CPU and line memory drop by the same factor, and the delays and damping
+// are rescaled so the tail keeps its decay time. The dry signal stays at the
+// full rate and is mixed there.
+// Host blocks need not be a multiple of the divider: inputs left over from
+// one block are decimated with the next, and the wet signal runs a constant
+// (divider - 1) samples behind to cover the gap.
+class MultirateReverb {
+public:
+  static constexpr int kMaxDivider = 4;
+  // The network never runs below this rate
+  static constexpr double kMinCoreRate = 44100.0;
+
+  struct Coefficients {
+    FDNReverb::Coefficients core;
+    float mix = 0.0f;
+  };
+
+  static int rateDivider(double sampleRate) {
+    int divider = 1;
+    while (divider < kMaxDivider && sampleRate / (2 * divider) >= kMinCoreRate)
+      divider *= 2;
+    return divider;
+  }
+
+  static Coefficients design(double size, double damp, double mix,
+                             double sampleRate) {
+    Coefficients c;
+    // Divided, the core renders the wet signal only and the mix happens at
+    // full rate; undivided, the core mixes itself
+    const int divider = rateDivider(sampleRate);
+    c.core = FDNReverb::design(size, damp, divider > 1 ? 100.0 : mix,
+                               sampleRate, divider);
+    c.mix = mix / 100.0;
+    return c;
+  }
+
+  // Samples at the full rate, including the resamplers' round trip
+  static double tailSamples(const Coefficients &c, double sampleRate) {
+    const int divider = rateDivider(sampleRate);
+    return FDNReverb::tailSamples(c.core) * divider + kChunk;
+  }
+
+  // Not real-time safe: sizes the network for the rate
+  void initialize(double sampleRate) {
+    divider = rateDivider(sampleRate);
+    core.initialize(divider);
+    // Short half-bands: the tail is damped and diffuse, a steep
+    // transition band would cost more than the slower core saves
+    for (auto &r : resamplers) {
+      r.initialize(8, 4);
+      r.setFactor(divider);
+    }
+    pending = 0;
+    wetCount = divider - 1;
+    for (auto &w : wet)
+      std::fill(w, w + kMaxDivider, 0.0f);
+  }
+
+  void setCoefficients(const Coefficients &c) {
+    core.setCoefficients(c.core);
+    mix = c.mix;
+  }
+
+  void process(const float *input, float *output, int numSamples) {
+    if (divider == 1) {
+      core.process(input, output, numSamples);
+      return;
+    }
+    const float *inputs[2] = {input, input};
+    float *outputs[2] = {output, output};
+    render<false>(inputs, outputs, numSamples);
   }
 
-  // Buffers and State
-  // Upsampler: Input buffer (at 1x rate) needs to store enough for 'taps/4'
-  // history. 64/4 = 16. Size 16 is enough. Let's make it 32 for safety.
-  std::vector<float> upBuffer = std::vector<float>(32, 0.0f);
-  int upMbIndex = 0;
+  // True stereo through one network
+  void process(const float *inputL, const float *inputR, float *outputL,
+               float *outputR, int numSamples) {
+    if (divider == 1) {
+      core.process(inputL, inputR, outputL, outputR, numSamples);
+      return;
+    }
+    const float *inputs[2] = {inputL, inputR};
+    float *outputs[2] = {outputL, outputR};
+    render<true>(inputs, outputs, numSamples);
+  }
 
-  // Downsampler: Input buffer (at 4x rate) needs to store 64 samples. Make it
-  // 128.
-  std::vector<float> downBuffer = std::vector<float>(128, 0.0f);
-  int downMbIndex = 0;
+private:
+  static constexpr int kChunk = 256; // full-rate samples per pass
+
+  template <bool Stereo>
+  void render(const float **inputs, float **outputs, int numSamples) {
+    const int channels = Stereo ? 2 : 1;
+    const float dry = 1.0f - mix;
+
+    while (numSamples > 0) {
+      const int n = std::min(numSamples, (int)kChunk);
+
+      // 1. Decimate everything that fills whole low-rate samples
+      const int total = pending + n;
+      const int lowCount = total / divider;
+      const int used = lowCount * divider;
+      for (int c = 0; c < channels; ++c) {
+        std::copy(inputs[c], inputs[c] + n, high[c] + pending);
+        resamplers[c].downsample(high[c], low[c], lowCount);
+      }
+
+      // 2. Tail at the low rate
+      if (Stereo)
+        core.process(low[0], low[1], low[0], low[1], lowCount);
+      else
+        core.process(low[0], low[0], lowCount);
+
+      // 3. Interpolate behind the wet samples still queued, keep the
+      // leftover inputs for the next pass
+      for (int c = 0; c < channels; ++c) {
+        resamplers[c].upsample(low[c], wet[c] + wetCount, lowCount);
+        std::copy(high[c] + used, high[c] + total, high[c]);
+      }
+      pending = total - used;
+      wetCount += used;
+
+      // 4. Mix at the full rate and drop the wet samples used
+      for (int c = 0; c < channels; ++c) {
+        const float *in = inputs[c];
+        float *out = outputs[c];
+        for (int i = 0; i < n; ++i)
+          out[i] = in[i] * dry + wet[c][i] * mix;
+        std::copy(wet[c] + n, wet[c] + wetCount, wet[c]);
+        inputs[c] += n;
+        outputs[c] += n;
+      }
+      wetCount -= n;
+      numSamples -= n;
+    }
+  }
+
+  FDNReverb core;
+  Oversampler resamplers[2];
+  int divider = 1;
+  float mix = 0.0f;
 
-  // Coeffs
-  std::vector<double> coeffs = std::vector<double>(64, 0.0);
+  // Full-rate inputs not yet decimated (pending) and wet samples not yet
+  // mixed (wetCount); pending + wetCount == divider - 1 between passes
+  int pending = 0;
+  int wetCount = 0;
+  float high[2][kChunk + kMaxDivider];
+  float low[2][kChunk + kMaxDivider];
+  float wet[2][kChunk + 2 * kMaxDivider];
 };
@@ -12,60 +12,182 @@
 #import <vector>
 
 #import <algorithm>
+#import <atomic>
 #import <cmath>
+#import <memory>
+#import <mutex>
 #import <vector>
 
+#import "AIVAnalysisWorker.hpp"
+#import "AIVConvolution.hpp"
 #import "AIVDSPClasses.hpp"
+#import "AIVDSPLanes.hpp"
 #import "AIVDSPKernelAdapter.h"
+#import "AIVLockFree.hpp"
+#import "AIVPitchDetector.hpp"
+#import "DSPKernel.hpp"
+#import "ParameterRamper.hpp"
 
 /*
  AIVDSPKernel
  As a non-ObjC class, this is safe to use from render thread.
  */
-class AIVDSPKernel {
+class AIVDSPKernel : public DSPKernel {
 public:
+  // Widest bus the kernel renders; further channels are ignored
+  static constexpr int kMaxChannels = 8;
+
+private:
+  // Channels are processed in stereo pairs, one pair per SIMD pass
+  static constexpr int kLanes = 2;
+
+  static constexpr int kParameterCount = AIVParameterAddressOversampling + 1;
+
+  // Parts of a coefficient set that are designed and applied together; an
+  // automation event only touches the stages its parameter drives
+  enum Stage : unsigned {
+    kStagePreamp = 1 << 0, // bypass, input gain, oversampling factor
+    kStageAutoLevel = 1 << 1,
+    kStagePitch = 1 << 2,
+    kStageGate = 1 << 3,
+    kStageDeesser = 1 << 4,
+    kStageEQ = 1 << 5,
+    kStageFilter = 1 << 6,
+    kStageCompressor = 1 << 7,
+    kStageSaturator = 1 << 8,
+    kStageDelay = 1 << 9,
+    kStageReverb = 1 << 10,
+    kStageLimiter = 1 << 11,
+    kStageLatency = 1 << 12, // the latency part of the tail
+    kAllStages = (1 << 13) - 1
+  };
+
+  // Everything the render thread takes from the parameter values, designed
+  // in one go (see designCoefficients / applyCoefficients)
+  struct CoefficientSet {
+    bool bypassed = false;
+
+    float inputGainLin = 1.0f, preampDrive = 1.0f, preampTanhNorm = 1.0f;
+    float saturation = 0.0f;
+    bool phaseInvert = false;
+
+    int oversampleFactor = 4;
+
+    bool gateEnable = false, deesserEnable = false, eqEnable = false,
+         compEnable = false, satEnable = false, delayEnable = false,
+         reverbEnable = false, pitchEnable = false, limiterEnable = false;
+    bool dynamicsLink = false;
+
+    AutoLevelLanes<kLanes>::Coefficients autoLevel;
+    PitchShifter::Coefficients pitch;
+    NoiseGateLanes<kLanes>::Coefficients gate;
+    DeesserLanes<kLanes>::Coefficients deesser;
+    ZDFFilterLanes<kLanes>::Coefficients safetyHPF, hpf, lpf;
+    double eq2G = 0.0;
+    float eq2Gain = 0, eq2Q = 0.7;
+    BiquadFilter::Coefficients eqBand3;
+    FETCompressorLanes<kLanes>::Coefficients compressor;
+    SaturatorLanes<kLanes>::Coefficients saturator;
+    DelayLine::Coefficients delay;
+    MultirateReverb::Coefficients reverb;
+    TruePeakLimiter::Coefficients limiter;
+    // Frames the output rings on after the input stops, by stage; without
+    // a loaded impulse response
+    double latencyTail = 0.0, delayTail = 0.0, reverbTail = 0.0;
+    // Automation events the values were read after (see publishCoefficients)
+    size_t eventGeneration = 0;
+  };
+
+public:
+  AIVDSPKernel() { resetParameterValues(); }
+
+  ~AIVDSPKernel() {
+    delete mPendingConvolution.load();
+    delete mRetiredConvolution.load();
+  }
+
   void initialize(int inputChannelCount, int outputChannelCount,
                   double inSampleRate) {
     mSampleRate = inSampleRate;
-    mChannelCount = inputChannelCount;
+    mChannelCount = std::min(inputChannelCount, (int)kMaxChannels);
 
-    // Resize DSP modules for each channel
-    mAutoLevel.resize(mChannelCount);
-    mGate.resize(mChannelCount);
+    // Resize DSP modules: lane modules per channel pair, the rest per channel
+    const int numPairs = (mChannelCount + kLanes - 1) / kLanes;
+    mAutoLevel.resize(numPairs);
+    mGate.resize(numPairs);
     mPitch.resize(mChannelCount);
-    mDeesser.resize(mChannelCount);
-    mSafetyHPF.resize(mChannelCount);
-    mHPF.resize(mChannelCount);
-    mLowMidCut.resize(mChannelCount);
+    mPitchDetector.resize(numPairs);
+    mDeesser.resize(numPairs);
+    mSafetyHPF.resize(numPairs);
+    mHPF.resize(numPairs);
+    mLowMidCut.resize(numPairs);
     // mEQBand3 remains Biquad HighShelf
-    mEQBand3.resize(mChannelCount);
-    mLPF.resize(mChannelCount);
-    mCompressor.resize(mChannelCount);
-    mSaturator.resize(mChannelCount);
+    mEQBand3.resize(numPairs);
+    mLPF.resize(numPairs);
+    mCompressor.resize(numPairs);
+    mSaturator.resize(numPairs);
     mDelay.resize(mChannelCount);
-    mReverb.resize(mChannelCount);
-    mOversampler.resize(mChannelCount);
+    mReverb.resize(numPairs); // true stereo, one network per pair
+    mPreampOversampler.resize(mChannelCount);
+    mDynamicsOversampler.resize(mChannelCount);
     mLimiter.resize(mChannelCount);
-    mNormalizer.resize(mChannelCount); // Add Normalizer
+    mLinkedLimiter.setChannelCount(mChannelCount);
+    mNormalizer.resize(numPairs); // Add Normalizer (linked per pair)
+    mNormalizerControls.assign(numPairs, CrossNormalizer::Controls());
+
+    mGainRamper.init();
+    mDezipperFrames = (AUAudioFrameCount)std::floor(0.02 * mSampleRate);
+    for (auto &ramp : mControlRamps)
+      ramp.active = false;
+    mActiveControlRamps = 0;
+    mSilentFrames = 0.0;
+    mSleeping = false;
+
+    // Buffers sized by the sample rate are allocated here, never when a
+    // parameter changes
+    for (auto &p : mPitch)
+      p.initialize(mSampleRate);
+    for (auto &d : mPitchDetector)
+      d.initialize(mSampleRate);
+    mDetectedPitch.store(0.0f, std::memory_order_relaxed);
+    mPitchConfidence.store(0.0f, std::memory_order_relaxed);
+    mRetiredMissedBlocks = 0;
+    mMissedReverbBlocks.store(0, std::memory_order_relaxed);
+    for (auto &n : mNormalizer)
+      n.initialize(mSampleRate);
+    for (auto &d : mDelay)
+      d.initialize(mSampleRate);
+    for (auto &r : mReverb)
+      r.initialize(mSampleRate);
 
-    for (auto &os : mOversampler)
+    for (auto &os : mPreampOversampler) {
       os.initialize();
+      os.setFactor(mOversampleFactor);
+    }
+    for (auto &os : mDynamicsOversampler) {
+      os.initialize();
+      os.setFactor(mOversampleFactor);
+    }
 
-    updatePreamp();
-    updateAutoLevel();
-    updateGate();
-    updatePitch();
-    updateDeesser();
-    updateEQ();
-    updateFilter();
-    updateComp();
-    updateDelay();
-    updateReverb();
-    updateLimiter();
+    updateControlRate();
+
+    // Render is stopped while resources are allocated, so the first set is
+    // taken over right away.
+    publishCoefficients();
+    applyPendingCoefficients();
+    for (auto &eq : mLowMidCut)
+      eq.reset();
+
+    if (mAsyncAnalysis)
+      mAnalysisWorker.start(numPairs, (int)mMaxFramesToRender, mSampleRate);
+    else
+      mAnalysisWorker.stop();
 
     // Resize scratch buffer for Interleaved handling (Stereo)
     // Max frames typically 1024, but allow for host resizing
     mScratchBuffer.resize(mMaxFramesToRender * 2);
+
+    resizeRenderBuffers();
   }
 
   float *getScratchPointer(int channel) {
@@ -74,410 +196,247 @@ public:
     return mScratchBuffer.data() + (channel * mMaxFramesToRender);
   }
 
-  void deInitialize() {}
+  void deInitialize() {
+    mAnalysisWorker.stop();
+    // Render is stopped: nothing else can touch the retired engine
+    delete mRetiredConvolution.exchange(nullptr);
+  }
 
   // MARK: - Bypass
   bool isBypassed() { return mBypassed; }
 
-  void setBypass(bool shouldBypass) { mBypassed = shouldBypass; }
-
-  // MARK: - Parameter Getter / Setter
-  void setParameter(AUParameterAddress address, AUValue value) {
-    switch (address) {
-    case AIVParameterAddressGain:
-      mGain = value;
-      break;
-    case AIVParameterAddressBypass:
-      mBypassed = (value > 0.5f);
-      break;
+  // True when the last render skipped the chain because the input had been
+  // silent for longer than the tail; the output is all zeros then
+  bool isOutputSilent() const { return mSleeping; }
 
-    // Preamp
-    case AIVParameterAddressInputGain:
-      mInputGainDb = value;
-      updatePreamp();
-      break;
-    case AIVParameterAddressSaturation:
-      mSaturation = value;
-      break;
-    case AIVParameterAddressPhaseInvert:
-      mPhaseInvert = (value > 0.5f);
-      break;
-
-    // Gate
-    case AIVParameterAddressGateThresh:
-      mGateThresh = value;
-      updateGate();
-      break;
-    case AIVParameterAddressGateRange:
-      mGateRange = value;
-      updateGate();
-      break;
-    case AIVParameterAddressGateAttack:
-      mGateAttack = value;
-      updateGate();
-      break;
-    case AIVParameterAddressGateHold:
-      mGateHold = value;
-      updateGate();
-      break;
-    case AIVParameterAddressGateRelease:
-      mGateRelease = value;
-      updateGate();
-      break;
-    case AIVParameterAddressGateHysteresis:
-      mGateHysteresis = value;
-      updateGate();
-      break;
-
-    // Auto Level
-    case AIVParameterAddressAutoLevelTarget:
-      mAutoLevelTarget = value;
-      updateAutoLevel();
-      break;
-    case AIVParameterAddressAutoLevelRange:
-      mAutoLevelRange = value;
-      updateAutoLevel();
-      break;
-    case AIVParameterAddressAutoLevelSpeed:
-      mAutoLevelSpeed = value;
-      updateAutoLevel();
-      break;
-
-    // Pitch
-    case AIVParameterAddressPitchAmount:
-      mPitchAmount = value;
-      updatePitch();
-      break;
-    case AIVParameterAddressPitchSpeed:
-      mPitchSpeed = value;
-      updatePitch();
-      break;
-
-    // Deesser
-    case AIVParameterAddressDeesserThresh:
-      mDeesserThresh = value;
-      updateDeesser();
-      break;
-    case AIVParameterAddressDeesserFreq:
-      mDeesserFreq = value;
-      updateDeesser();
-      break;
-    case AIVParameterAddressDeesserRatio:
-      mDeesserRatio = value;
-      updateDeesser();
-      break;
-    case AIVParameterAddressDeesserRange:
-      mDeesserRange = value;
-      updateDeesser();
-      break;
-
-    // EQ
-    case AIVParameterAddressEQBand1Freq:
-      mEQ1Freq = value;
-      updateEQ();
-      break;
-    case AIVParameterAddressEQBand1Gain:
-      mEQ1Gain = value;
-      updateEQ();
-      break;
-    case AIVParameterAddressEQBand1Q:
-      mEQ1Q = value;
-      updateEQ();
-      break;
-    case AIVParameterAddressEQBand2Freq:
-      mEQ2Freq = value;
-      updateEQ();
-      break;
-    case AIVParameterAddressEQBand2Gain:
-      mEQ2Gain = value;
-      updateEQ();
-      break;
-    case AIVParameterAddressEQBand2Q:
-      mEQ2Q = value;
-      updateEQ();
-      break;
-    case AIVParameterAddressEQBand3Freq:
-      mEQ3Freq = value;
-      updateEQ();
-      break;
-    case AIVParameterAddressEQBand3Gain:
-      mEQ3Gain = value;
-      updateEQ();
-      break;
-    case AIVParameterAddressEQBand3Q:
-      mEQ3Q = value;
-      updateEQ();
-      break;
-
-    // Filter (LPF)
-    case AIVParameterAddressCutoff:
-      mCutoff = value;
-      updateFilter();
-      break;
-    case AIVParameterAddressResonance:
-      mResonance = value;
-      updateFilter();
-      break;
-
-    // Compressor
-    case AIVParameterAddressCompThresh:
-      mCompThresh = value;
-      updateComp();
-      break;
-    case AIVParameterAddressCompRatio:
-      mCompRatio = value;
-      updateComp();
-      break;
-    case AIVParameterAddressCompAttack:
-      mCompAttack = value;
-      updateComp();
-      break;
-    case AIVParameterAddressCompRelease:
-      mCompRelease = value;
-      updateComp();
-      break;
-    case AIVParameterAddressCompMakeup:
-      mCompMakeup = value;
-      updateComp();
-      break;
-    case AIVParameterAddressCompAutoMakeup:
-      mCompAutoMakeup = (value > 0.5f);
-      updateComp();
-      break;
-
-    // Saturation
-    case AIVParameterAddressSatDrive:
-      mSatDrive = value;
-      for (auto &s : mSaturator)
-        s.setParameters(mSatDrive, mSatType, mSampleRate);
-      break;
-    case AIVParameterAddressSatType:
-      mSatType = value;
-      for (auto &s : mSaturator)
-        s.setParameters(mSatDrive, mSatType, mSampleRate);
-      break;
-
-    // Delay
-    case AIVParameterAddressDelayTime:
-      mDelayTime = value;
-      updateDelay();
-      break;
-    case AIVParameterAddressDelayFeedback:
-      mDelayFeedback = value;
-      updateDelay();
-      break;
-    case AIVParameterAddressDelayMix:
-      mDelayMix = value;
-      updateDelay();
-      break;
-
-    // Reverb
-    case AIVParameterAddressReverbSize:
-      mReverbSize = value;
-      updateReverb();
-      break;
-    case AIVParameterAddressReverbDamp:
-      mReverbDamp = value;
-      updateReverb();
-      break;
-    case AIVParameterAddressReverbMix:
-      mReverbMix = value;
-      updateReverb();
-      break;
+  void setBypass(bool shouldBypass) {
+    setParameter(AIVParameterAddressBypass, shouldBypass ? 1.0f : 0.0f);
+  }
 
-    // Limiter
-    case AIVParameterAddressLimiterCeiling:
-      mLimiterCeiling = value;
-      updateLimiter();
-      break;
-    case AIVParameterAddressLimiterLookahead:
-      mLimiterLookahead = value;
-      updateLimiter();
-      break;
+  // MARK: - Analysis Mode
+  // Runs the CrossNormalizer analysis on a worker thread instead of the
+  // render thread; its controls then arrive one block late. Takes effect at
+  // the next initialize().
+  bool isAsyncAnalysis() const { return mAsyncAnalysis; }
+
+  void setAsyncAnalysis(bool async) { mAsyncAnalysis = async; }
+
+  // MARK: - Convolution Reverb
+  // Loads an impulse response into the reverb slot: the first channel pair
+  // then runs through ConvolutionReverb instead of the FDN, with the same
+  // mix. An empty response (length 0) goes back to the FDN. Not real-time
+  // safe: the engine is built on the calling thread and handed over for the
+  // render thread to take at its next buffer. One loading thread at a time.
+  void loadImpulseResponse(const float *const *channels, int numChannels,
+                           int length) {
+    auto *engine = new ConvolutionReverb(channels, numChannels, length);
+    // A response the render thread has not taken yet is replaced
+    delete mPendingConvolution.exchange(engine, std::memory_order_acq_rel);
+    // The engine it let go of last time is freed here, which also frees
+    // the slot it needs to take the new one
+    delete mRetiredConvolution.exchange(nullptr, std::memory_order_acq_rel);
+  }
 
-    // Enables
-    case AIVParameterAddressGateEnable:
-      mGateEnable = (value > 0.5f);
-      break;
-    case AIVParameterAddressDeesserEnable:
-      mDeesserEnable = (value > 0.5f);
-      break;
-    case AIVParameterAddressEQEnable:
-      mEQEnable = (value > 0.5f);
-      break;
-    case AIVParameterAddressCompEnable:
-      mCompEnable = (value > 0.5f);
-      break;
-    case AIVParameterAddressSatEnable:
-      mSatEnable = (value > 0.5f);
-      break;
-    case AIVParameterAddressDelayEnable:
-      mDelayEnable = (value > 0.5f);
-      break;
-    case AIVParameterAddressReverbEnable:
-      mReverbEnable = (value > 0.5f);
-      break;
-    case AIVParameterAddressPitchEnable:
-      mPitchEnable = (value > 0.5f);
-      break;
-    case AIVParameterAddressLimiterEnable:
-      mLimiterEnable = (value > 0.5f);
-      break;
+  // MARK: - Parameter Getter / Setter
+  // Called from the UI / main thread. The new value is stored, a complete
+  // coefficient set is designed here, on the calling thread, and published
+  // for the render thread to take over at its next slice boundary. Nothing
+  // the render thread is using is touched.
+  void setParameter(AUParameterAddress address, AUValue value) {
+    if (address >= kParameterCount)
+      return;
+    if (address == AIVParameterAddressGain) {
+      mGainRamper.setUIValue(value);
+      return;
     }
+    mParameterValues[address].store(value, std::memory_order_relaxed);
+    publishCoefficients();
   }
 
   AUValue getParameter(AUParameterAddress address) {
-    switch (address) {
-    case AIVParameterAddressGateEnable:
-      return (AUValue)(mGateEnable ? 1.0f : 0.0f);
-    case AIVParameterAddressDeesserEnable:
-      return (AUValue)(mDeesserEnable ? 1.0f : 0.0f);
-    case AIVParameterAddressEQEnable:
-      return (AUValue)(mEQEnable ? 1.0f : 0.0f);
-    case AIVParameterAddressCompEnable:
-      return (AUValue)(mCompEnable ? 1.0f : 0.0f);
-    case AIVParameterAddressSatEnable:
-      return (AUValue)(mSatEnable ? 1.0f : 0.0f);
-    case AIVParameterAddressDelayEnable:
-      return (AUValue)(mDelayEnable ? 1.0f : 0.0f);
-    case AIVParameterAddressReverbEnable:
-      return (AUValue)(mReverbEnable ? 1.0f : 0.0f);
-    case AIVParameterAddressPitchEnable:
-      return (AUValue)(mPitchEnable ? 1.0f : 0.0f);
-    case AIVParameterAddressLimiterEnable:
-      return (AUValue)(mLimiterEnable ? 1.0f : 0.0f);
-
-    case AIVParameterAddressGain:
-      return (AUValue)mGain;
-    case AIVParameterAddressBypass:
-      return (AUValue)(mBypassed ? 1.0f : 0.0f);
-
-    case AIVParameterAddressInputGain:
-      return mInputGainDb;
-    case AIVParameterAddressSaturation:
-      return mSaturation;
-    case AIVParameterAddressPhaseInvert:
-      return (AUValue)(mPhaseInvert ? 1.0f : 0.0f);
+    if (address >= kParameterCount)
+      return 0.f;
+    if (address == AIVParameterAddressGain)
+      return mGainRamper.getUIValue();
+    return parameterValue((AIVParameterAddress)address);
+  }
 
-    case AIVParameterAddressAutoLevelTarget:
-      return mAutoLevelTarget;
-    case AIVParameterAddressAutoLevelRange:
-      return mAutoLevelRange;
-    case AIVParameterAddressAutoLevelSpeed:
-      return mAutoLevelSpeed;
+  // MARK: - Max Frames
+  AUAudioFrameCount maximumFramesToRender() const { return mMaxFramesToRender; }
 
-    case AIVParameterAddressPitchAmount:
-      return mPitchAmount;
-    case AIVParameterAddressPitchSpeed:
-      return mPitchSpeed;
+  void setMaximumFramesToRender(const AUAudioFrameCount &maxFrames) {
+    mMaxFramesToRender = maxFrames;
+    mScratchBuffer.resize(mMaxFramesToRender * 2);
+    resizeRenderBuffers();
+  }
 
-    case AIVParameterAddressDeesserThresh:
-      return mDeesserThresh;
-    case AIVParameterAddressDeesserFreq:
-      return mDeesserFreq;
-    case AIVParameterAddressDeesserRatio:
-      return mDeesserRatio;
-    case AIVParameterAddressDeesserRange:
-      return mDeesserRange;
+  // MARK: - Musical Context
+  void setMusicalContextBlock(AUHostMusicalContextBlock contextBlock) {
+    mMusicalContextBlock = contextBlock;
+  }
 
-    case AIVParameterAddressEQBand1Freq:
-      return mEQ1Freq;
-    case AIVParameterAddressEQBand1Gain:
-      return mEQ1Gain;
-    case AIVParameterAddressEQBand1Q:
-      return mEQ1Q;
-    case AIVParameterAddressEQBand2Freq:
-      return mEQ2Freq;
-    case AIVParameterAddressEQBand2Gain:
-      return mEQ2Gain;
-    case AIVParameterAddressEQBand2Q:
-      return mEQ2Q;
-    case AIVParameterAddressEQBand3Freq:
-      return mEQ3Freq;
-    case AIVParameterAddressEQBand3Gain:
-      return mEQ3Gain;
-    case AIVParameterAddressEQBand3Q:
-      return mEQ3Q;
+  /**
+   MARK: - Render
+   The adapter hands the host buffers over with beginRender(), then calls
+   processWithEvents(), which splits the buffer at each event's sample time
+   and renders the pieces through process(frameCount, bufferOffset).
+   */
+  void beginRender(float **inputBuffers, float **outputBuffers,
+                   AUAudioFrameCount frameCount, int channelCount,
+                   bool inputSilent) {
+    mRenderChannelCount = std::min(channelCount, mChannelCount);
+    for (int channel = 0; channel < mRenderChannelCount; ++channel) {
+      mInputBuffers[channel] = inputBuffers[channel];
+      mOutputBuffers[channel] = outputBuffers[channel];
+    }
 
-    case AIVParameterAddressCompThresh:
-      return mCompThresh;
-    case AIVParameterAddressCompRatio:
-      return mCompRatio;
-    case AIVParameterAddressCompAttack:
-      return mCompAttack;
-    case AIVParameterAddressCompRelease:
-      return mCompRelease;
-    case AIVParameterAddressCompMakeup:
-      return mCompMakeup;
-    case AIVParameterAddressCompAutoMakeup:
-      return (AUValue)(mCompAutoMakeup ? 1.0f : 0.0f);
+    applyPendingCoefficients();
+    takePendingConvolution();
+
+    // UI changes to the output gain glide instead of stepping
+    mGainRamper.dezipperCheck(mDezipperFrames);
+
+    // Sleep once the input has been silent for longer than everything in
+    // the chain rings on; any sound wakes the chain on this buffer. The
+    // host's silence flag is trusted, otherwise the input is scanned.
+    if (!inputSilent)
+      inputSilent = isSilent(inputBuffers, (int)frameCount);
+    mSilentFrames = inputSilent ? mSilentFrames + frameCount : 0.0;
+    double tailFrames = mLatencyTail + mDelayTail + mReverbTail;
+    if (mReverbEnable && mConvolution && !mConvolution->empty())
+      tailFrames += mConvolution->tailSamples();
+    const bool sleeping = !mBypassed && mSilentFrames > tailFrames;
+    if (sleeping && !mSleeping) {
+      // Nothing to detect until the input returns
+      mDetectedPitch.store(0.0f, std::memory_order_relaxed);
+      mPitchConfidence.store(0.0f, std::memory_order_relaxed);
+    }
+    mSleeping = sleeping;
 
-    case AIVParameterAddressGateThresh:
-      return mGateThresh;
-    case AIVParameterAddressGateRange:
-      return mGateRange;
-    case AIVParameterAddressGateAttack:
-      return mGateAttack;
-    case AIVParameterAddressGateHold:
-      return mGateHold;
-    case AIVParameterAddressGateRelease:
-      return mGateRelease;
-    case AIVParameterAddressGateHysteresis:
-      return mGateHysteresis;
+    if (mBypassed || mSleeping)
+      return;
 
-    case AIVParameterAddressLimiterCeiling:
-      return mLimiterCeiling;
-    case AIVParameterAddressLimiterLookahead:
-      return mLimiterLookahead;
+    // --- CROSSNORMALIZER LOGIC ---
+    // 1. Analyze Input (Tap A)
+    // The analysis smooths once per call, so it runs over the whole host
+    // buffer here rather than per event slice; its controls then hold for
+    // every slice of this buffer.
+    // Each channel pair is analyzed once, linked, and shares the controls.
+    for (int pair = 0; pair * kLanes < mRenderChannelCount; ++pair) {
+      const float *pairInputs[kLanes];
+      int numInputs = 0;
+      // Gate Status: Needed for AutoLevel link. Open if either lane is.
+      float internalGateState = 0.0f;
+      for (int lane = 0; lane < kLanes; ++lane) {
+        const int channel = pair * kLanes + lane;
+        if (channel >= mRenderChannelCount || !inputBuffers[channel])
+          continue;
+        pairInputs[numInputs++] = inputBuffers[channel];
+        if (mGate[pair].isOpen(lane))
+          internalGateState = 1.0f;
+      }
+      if (numInputs == 0)
+        continue;
+      // Comp GR: potentially needed, currently unused by implementation.
 
-    case AIVParameterAddressSatDrive:
-      return mSatDrive;
-    case AIVParameterAddressSatType:
-      return mSatType;
+      if (mAsyncAnalysis) {
+        // Queue this buffer; take whatever the worker has finished since
+        mAnalysisWorker.push(pair, pairInputs, numInputs, (int)frameCount,
+                             internalGateState);
+        if (const auto *controls = mAnalysisWorker.acquire(pair))
+          mNormalizerControls[pair] = *controls;
+      } else {
+        mNormalizer[pair].processLogic(pairInputs, numInputs, frameCount,
+                                       internalGateState, 0.0f, mSampleRate);
+        mNormalizerControls[pair] = mNormalizer[pair].getControls();
+      }
 
-    case AIVParameterAddressDelayTime:
-      return mDelayTime;
-    case AIVParameterAddressDelayFeedback:
-      return mDelayFeedback;
-    case AIVParameterAddressDelayMix:
-      return mDelayMix;
+      // Dynamic EQ (Mud Cut on Band 2)
+      // mEQ2Gain is the *Base* gain; the cut is added per pair. The band
+      // only re-targets when the cut has moved, then glides to it across
+      // this buffer.
+      mLowMidCut[pair].setTarget(mEQ2G, mEQ2Q,
+                                 mEQ2Gain + mNormalizerControls[pair].mudEqCut,
+                                 (int)frameCount);
+    }
+  }
 
-    case AIVParameterAddressReverbSize:
-      return mReverbSize;
-    case AIVParameterAddressReverbDamp:
-      return mReverbDamp;
-    case AIVParameterAddressReverbMix:
-      return mReverbMix;
+  void process(AUAudioFrameCount frameCount,
+               AUAudioFrameCount bufferOffset) override {
+    float *inputs[kMaxChannels];
+    float *outputs[kMaxChannels];
+
+    while (frameCount > 0) {
+      // Sets published from the UI thread land at slice boundaries
+      applyPendingCoefficients();
+
+      // While a parameter ramps at control rate, render in short slices and
+      // move the parameter between them.
+      AUAudioFrameCount sliceFrames = frameCount;
+      if (mActiveControlRamps > 0) {
+        sliceFrames = std::min(sliceFrames, (AUAudioFrameCount)kControlRampFrames);
+        stepControlRamps(sliceFrames);
+      }
 
-    case AIVParameterAddressCutoff:
-      return mCutoff;
-    case AIVParameterAddressResonance:
-      return mResonance;
+      for (int channel = 0; channel < mRenderChannelCount; ++channel) {
+        inputs[channel] = mInputBuffers[channel]
+                              ? mInputBuffers[channel] + bufferOffset
+                              : nullptr;
+        outputs[channel] = mOutputBuffers[channel]
+                               ? mOutputBuffers[channel] + bufferOffset
+                               : nullptr;
+      }
+      processSlice(inputs, outputs, sliceFrames, mRenderChannelCount);
 
-    default:
-      return 0.f;
+      frameCount -= sliceFrames;
+      bufferOffset += sliceFrames;
     }
   }
 
-  // MARK: - Max Frames
-  AUAudioFrameCount maximumFramesToRender() const { return mMaxFramesToRender; }
-
-  void setMaximumFramesToRender(const AUAudioFrameCount &maxFrames) {
-    mMaxFramesToRender = maxFrames;
-    mScratchBuffer.resize(mMaxFramesToRender * 2);
-  }
+  // Parameter and ramp events arrive here at their sample time. The output
+  // gain ramps per sample; every other parameter drives coefficients, so
+  // its ramp is followed at control rate (kControlRampFrames).
+  void startRamp(AUParameterAddress address, AUValue value,
+                 AUAudioFrameCount duration) override {
+    if (address == AIVParameterAddressGain) {
+      mGainRamper.startRamp(value, duration);
+      return;
+    }
+    if (duration == 0) {
+      cancelControlRamp(address);
+      applyParameter(address, value);
+      return;
+    }
 
-  // MARK: - Musical Context
-  void setMusicalContextBlock(AUHostMusicalContextBlock contextBlock) {
-    mMusicalContextBlock = contextBlock;
+    ControlRamp *slot = nullptr;
+    for (auto &ramp : mControlRamps) {
+      if (ramp.active && ramp.address == address) {
+        slot = &ramp; // Retarget from wherever the running ramp is
+        break;
+      }
+      if (!ramp.active && !slot)
+        slot = &ramp;
+    }
+    if (!slot) {
+      // All slots busy: jump to the target rather than drop the event
+      applyParameter(address, value);
+      return;
+    }
+    if (!slot->active) {
+      slot->address = address;
+      slot->ramper.startRamp(getParameter(address), 0);
+      slot->active = true;
+      ++mActiveControlRamps;
+    }
+    slot->ramper.startRamp(value, duration);
   }
 
+private:
   /**
    MARK: - Internal Process
    */
-  void process(float **inputBuffers, float **outputBuffers,
-               AUEventSampleTime bufferStartTime, AUAudioFrameCount frameCount,
-               int channelCount) {
+  void processSlice(float **inputBuffers, float **outputBuffers,
+                    AUAudioFrameCount frameCount, int channelCount) {
 
     if (mBypassed) {
       for (int channel = 0; channel < channelCount; ++channel) {
@@ -486,179 +445,309 @@ public:
                       outputBuffers[channel]);
         }
       }
+      mGainRamper.stepBy(frameCount);
       return;
     }
 
-    for (int channel = 0; channel < channelCount; ++channel) {
-      // Safety check
-      if (channel >= mPitch.size())
-        break;
-      if (!inputBuffers[channel] || !outputBuffers[channel])
+    if (mSleeping) {
+      for (int channel = 0; channel < channelCount; ++channel)
+        if (outputBuffers[channel])
+          std::fill_n(outputBuffers[channel], frameCount, 0.0f);
+      mGainRamper.stepBy(frameCount);
+      return;
+    }
+
+    channelCount = std::min(channelCount, mChannelCount);
+    const int osCount = (int)frameCount * mOversampleFactor;
+
+    // Channel buffers for the lane section; missing channels (mono, or a
+    // null host buffer) are fed from the silent pad lane.
+    float *laneChannels[kMaxChannels];
+    std::fill_n(laneChannels, kMaxChannels, mPadLane.data());
+
+    // --- FRONT END (per channel) ---
+    for (int channel = 0; channel < mChannelCount; ++channel) {
+      const int pair = channel / kLanes, lane = channel % kLanes;
+
+      if (channel >= channelCount || !inputBuffers[channel] ||
+          !outputBuffers[channel])
         continue;
 
       float *in = inputBuffers[channel];
       float *out = outputBuffers[channel];
+      laneChannels[channel] = out;
 
       // --- CROSSNORMALIZER LOGIC ---
-      // 1. Analyze Input (Tap A)
-      // Pass the raw input buffer for analysis.
-      // Gate Status: Needed for AutoLevel link.
-      float internalGateState = mGate[channel].isOpen() ? 1.0f : 0.0f;
-      // Comp GR: potentially needed, currently unused by implementation.
+      // 2. Retrieve & Apply Controls (analysis ran in beginRender)
+      float autoGainDB = mNormalizerControls[pair].autoLevelGain;
+      float compThreshAdj = mNormalizerControls[pair].compThresholdAdjust;
+      float satScaler = mNormalizerControls[pair].satDriveScaler;
 
-      mNormalizer[channel].processLogic(in, frameCount, internalGateState, 0.0f,
-                                        mSampleRate);
+      // Update Modules
+      mAutoLevel[pair].setGainOffset(lane, autoGainDB);
+      mCompressor[pair].setThresholdOffset(lane, compThreshAdj);
+      mSaturator[pair].setDriveScale(lane, satScaler);
+
+      // --- OVERSAMPLING ISLANDS ---
+      // Only the nonlinear stages run oversampled, each inside its own
+      // up/down pair. The linear and envelope-only modules between them run
+      // at 1x, where they cost a fraction as much and see the rate their
+      // buffers and time constants are sized for.
+      // Each island upsamples the whole host buffer into the scratch span so
+      // that its modules run one tight loop over it (stage-major).
+      float *os = mOversampledBuffer.data();
+
+      // 0. Preamp & Saturation (Step 1.1) - Island A (Nx)
+      /*
+       Physics: y = tanh(k * x) / tanh(k)
+       Ideally Preamp saturation benefits most from OS.
+       */
+      // --- SAFETY PAD (CrossNormalizer) ---
+      // Pre-attenuate signals > -3dBFS to roughly -6dBFS before saturator.
+      // The Normalizer's getter returns a value smoothed per block, so it is
+      // constant across this span.
+      mPreampOversampler[channel].upsample(in, os, frameCount);
+      {
+        const float safetyPad = mNormalizerControls[pair].safetyPad;
+        const float k_val = mPreampDrive;
+        const float tanhNorm = mPreampTanhNorm;
+        const float mix = mSaturation / 100.0f;
+        const float polarity = mPhaseInvert ? -1.0f : 1.0f;
+
+        for (int i = 0; i < osCount; ++i) {
+          float inputSample = os[i] * safetyPad;
+          float drySample = inputSample * mInputGainLin;
+          float wetSample = FastMath::tanh(k_val * inputSample) * tanhNorm;
+          os[i] = polarity * ((1.0f - mix) * drySample + mix * wetSample);
+        }
+      }
+      mPreampOversampler[channel].downsample(os, out, frameCount);
+    }
 
-      // 2. Retrieve & Apply Controls
-      float autoGainDB = mNormalizer[channel].getAutoLevelGain();
-      float compThreshAdj = mNormalizer[channel].getCompThresholdAdjust();
-      float mudCut = mNormalizer[channel].getMudEqCut();
-      float satScaler = mNormalizer[channel].getSatDriveScaler();
+    // --- CORE PROCESS (1x, channel pairs in SIMD lanes) ---
+    // Each pair of channels is interleaved once and every module below runs
+    // both channels per pass (see AIVDSPLanes.hpp).
+    const int numPairs = (mChannelCount + kLanes - 1) / kLanes;
+    for (int pair = 0; pair < numPairs; ++pair) {
+      float *const *channels = laneChannels + pair * kLanes;
+      float *lanes = mLaneBuffer.data();
+      std::fill_n(mPadLane.data(), frameCount, 0.0f);
+      interleaveLanes<kLanes>(channels, lanes, frameCount);
+
+      // 0b. Noise Gate
+      if (mGateEnable)
+        mGate[pair].processBlock(lanes, frameCount);
+
+      // 1. Auto Level
+      mAutoLevel[pair].processBlock(lanes, frameCount);
+
+      // 2. Pitch (per channel, strided over the lanes)
+      if (mPitchEnable) {
+        // f0 of the pair before it is shifted; the first pair's estimate is
+        // published for the UI
+        if (mPitchDetector[pair].process(lanes, kLanes, frameCount) > 0 &&
+            pair == 0) {
+          mDetectedPitch.store(mPitchDetector[0].getPitch(),
+                               std::memory_order_relaxed);
+          mPitchConfidence.store(mPitchDetector[0].getConfidence(),
+                                 std::memory_order_relaxed);
+        }
+        const float f0 = mPitchDetector[pair].getPitch();
+        for (int lane = 0; lane < kLanes; ++lane) {
+          const int channel = pair * kLanes + lane;
+          if (channel >= mChannelCount)
+            break;
+          mPitch[channel].setPitch(f0);
+          for (UInt32 i = 0; i < frameCount; ++i)
+            lanes[i * kLanes + lane] =
+                mPitch[channel].process(lanes[i * kLanes + lane]);
+        }
+      }
 
-      // Update Modules
-      mAutoLevel[channel].setGainOffset(autoGainDB);
-      mCompressor[channel].setThresholdOffset(compThreshAdj);
-      mSaturator[channel].setDriveScale(satScaler);
+      // 2. Deesser
+      if (mDeesserEnable)
+        mDeesser[pair].processBlock(lanes, frameCount);
+
+      // 3. EQ
+      if (mEQEnable) {
+        mSafetyHPF[pair].processBlock(lanes, frameCount);
+        mHPF[pair].processBlock(lanes, frameCount);
+        mLowMidCut[pair].processBlock(lanes, frameCount);
+        mEQBand3[pair].processBlock(lanes, frameCount);
+        mLPF[pair].processBlock(lanes, frameCount);
+      }
 
-      // Dynamic EQ (Mud Cut on Band 2)
-      // We need to re-calculate coefficients if they change.
-      // Checking for change would be efficient, but for now we bluntly set.
-      // Note: Recalculating Biquad coeffs per block is cheap enough over 1000
-      // blocks/sec. We assume mEQ2Gain is the *Base* gain. We add cut. Wait,
-      // mLowMidCut is vector of Biquad. We need to access mLowMidCut[channel]
-      // and set its params. But unlike others, Biquad doesn't store base
-      // params. We have mEQ2Freq, mEQ2Q, mEQ2Gain stored in members.
-      double currentQ = std::max(0.1f, std::min(mEQ2Q, 10.0f));
-      double dynamicGain = mEQ2Gain + mudCut;
-      mLowMidCut[channel].calculateCoefficients(BiquadFilter::Peaking, mEQ2Freq,
-                                                currentQ, dynamicGain,
-                                                mSampleRate * 4.0);
-
-      for (UInt32 frameIndex = 0; frameIndex < frameCount; ++frameIndex) {
-        float sample = in[frameIndex];
-
-        // --- UPSAMPLE (1 -> 4) ---
-        float osBlock[4];
-        mOversampler[channel].processUpsample(sample, osBlock);
-
-        float processedBlock[4];
-
-        // --- CORE PROCESS LOOP (4x) ---
-        for (int k = 0; k < 4; ++k) {
-          float s = osBlock[k];
-
-          // 0. Preamp & Saturation (Step 1.1) - Now running at 4x
-          /*
-           Physics: y = tanh(k * x) / tanh(k)
-           Ideally Preamp saturation benefits most from OS.
-           */
-          float inputSample = s;
-
-          // --- SAFETY PAD (CrossNormalizer) ---
-          // Pre-attenuate signals > -3dBFS to roughly -6dBFS before saturator
-          // This is a dynamic input pad.
-          // Note: In strict implementation, this should be smoothed.
-          // The Normalizer's getter returns a smoothed value.
-          float safetyPad = mNormalizer[channel].getSafetyPad();
-          inputSample *= safetyPad;
-
-          float linearSample = inputSample * mInputGainLin;
-
-          float k_val = (mInputGainLin < 0.01f) ? 0.01f : mInputGainLin;
-          float wetSample = std::tanh(k_val * inputSample) / std::tanh(k_val);
-
-          float drySample = linearSample;
-          float mix = mSaturation / 100.0f;
-          s = (1.0f - mix) * drySample + mix * wetSample;
-
-          // Phase Invert
-          if (mPhaseInvert) {
-            s = -s;
-          }
-
-          // 0b. Noise Gate
-          if (mGateEnable)
-            s = mGate[channel].process(s);
-
-          // 1. Auto Level
-          s = mAutoLevel[channel].process(s);
-
-          // 2. Pitch
-          if (mPitchEnable)
-            s = mPitch[channel].process(s);
-
-          // 2. Deesser
-          if (mDeesserEnable)
-            s = mDeesser[channel].process(s);
-
-          // 3. EQ
-          if (mEQEnable) {
-            s = mSafetyHPF[channel].process(s);
-            s = mHPF[channel].process(s);
-            s = mLowMidCut[channel].process(s);
-            // s = mLowMidCut[channel].process(s); // REMOVED DUPLICATE
-            s = mEQBand3[channel].process(s);
-            s = mLPF[channel].process(s);
-          }
-
-          // 3. Compressor (FET / AIV 76)
-          if (mCompEnable)
-            s = mCompressor[channel].process(s);
-
-          // 4. Saturator (Module)
-          if (mSatEnable)
-            s = mSaturator[channel].process(s);
-
-          processedBlock[k] = s;
+      // 3-4. Compressor & Saturator - Island B (Nx)
+      // The two are adjacent in the chain, so they share one up/down pair;
+      // a round trip between them would only add latency.
+      // Each channel is oversampled on its own and the results interleaved
+      // so the modules still run both lanes per pass.
+      if (isDynamicsIslandActive()) {
+        deinterleaveLanes<kLanes>(lanes, channels, frameCount);
+
+        float *osLanes = mOversampledBuffer.data();
+        float *osChannels[kLanes];
+        for (int lane = 0; lane < kLanes; ++lane) {
+          const int channel = pair * kLanes + lane;
+          osChannels[lane] = osLanes + (kLanes + lane) * mOversampledSpan;
+          if (channel < mChannelCount)
+            mDynamicsOversampler[channel].upsample(channels[lane],
+                                                   osChannels[lane], frameCount);
+          else
+            std::fill_n(osChannels[lane], osCount, 0.0f);
+        }
+        interleaveLanes<kLanes>(osChannels, osLanes, osCount);
+
+        // 3. Compressor (FET / AIV 76)
+        if (mCompEnable)
+          mCompressor[pair].processBlock(osLanes, osCount);
+
+        // 4. Saturator (Module)
+        if (mSatEnable)
+          mSaturator[pair].processBlock(osLanes, osCount);
+
+        deinterleaveLanes<kLanes>(osLanes, osChannels, osCount);
+        for (int lane = 0; lane < kLanes; ++lane) {
+          const int channel = pair * kLanes + lane;
+          if (channel < mChannelCount)
+            mDynamicsOversampler[channel].downsample(osChannels[lane],
+                                                     channels[lane], frameCount);
         }
+      } else {
+        deinterleaveLanes<kLanes>(lanes, channels, frameCount);
+      }
+    }
+
+    // --- POST PROCESS (1x, per channel) ---
+    // The output gain ramp is stepped once and shared by all channels
+    float *gainRamp = mGainRampBuffer.data();
+    for (UInt32 frameIndex = 0; frameIndex < frameCount; ++frameIndex)
+      gainRamp[frameIndex] = mGainRamper.getAndStep();
+
+    auto hasChannel = [&](int channel) {
+      return channel < channelCount && inputBuffers[channel] &&
+             outputBuffers[channel];
+    };
+
+    // 5. Delay
+    if (mDelayEnable) {
+      for (int channel = 0; channel < channelCount; ++channel)
+        if (hasChannel(channel))
+          mDelay[channel].processBlock(outputBuffers[channel], frameCount);
+    }
 
-        // --- DOWNSAMPLE (4 -> 1) ---
-        sample = mOversampler[channel].processDownsample(processedBlock);
+    // 6. Reverb (per pair: a full pair runs through one stereo network; a
+    // loaded impulse response replaces the network on the first pair)
+    if (mReverbEnable) {
+      ConvolutionReverb *convolution =
+          mConvolution && !mConvolution->empty() ? mConvolution.get() : nullptr;
+      for (int pair = 0; pair * kLanes < channelCount; ++pair) {
+        const int left = pair * kLanes, right = left + 1;
+        float *outL = hasChannel(left) ? outputBuffers[left] : nullptr;
+        float *outR = hasChannel(right) ? outputBuffers[right] : nullptr;
+        // A lone channel runs mono
+        if (!outL)
+          std::swap(outL, outR);
+        if (!outL)
+          continue;
+        if (!outR)
+          outR = outL;
+
+        if (pair == 0 && convolution) {
+          convolution->process(outL, outR, outL, outR, frameCount,
+                               mReverbMix);
+          mMissedReverbBlocks.store(mRetiredMissedBlocks +
+                                        convolution->missedTailBlocks(),
+                                    std::memory_order_relaxed);
+        }
+        else if (outR != outL)
+          mReverb[pair].process(outL, outR, outL, outR, frameCount);
+        else
+          mReverb[pair].process(outL, outL, frameCount);
+      }
+    }
 
-        // --- POST PROCESS (1x) ---
+    // 7. Limiter, linked: one gain for every channel of the bus. Channels
+    // keep their own place, so each meets its own lookahead audio.
+    if (mLimiterEnable && mDynamicsLink) {
+      float *linked[kMaxChannels];
+      for (int channel = 0; channel < channelCount; ++channel)
+        linked[channel] =
+            hasChannel(channel) ? outputBuffers[channel] : nullptr;
+      mLinkedLimiter.processBlock(linked, channelCount, frameCount);
+    }
 
-        // 5. Delay
-        if (mDelayEnable)
-          sample = mDelay[channel].process(sample);
+    for (int channel = 0; channel < channelCount; ++channel) {
+      if (!hasChannel(channel))
+        continue;
+      float *out = outputBuffers[channel];
 
-        // 6. Reverb
-        if (mReverbEnable)
-          sample = mReverb[channel].process(sample);
+      // 7. Limiter (TruePeak - 1x is fine as it implements its own
+      // lookahead/ISP check logic if robust, or just relies on previous OS
+      // being clean)
+      if (mLimiterEnable && !mDynamicsLink)
+        mLimiter[channel].processBlock(out, frameCount);
 
-        // 7. Limiter (TruePeak - 1x is fine as it implements its own
-        // lookahead/ISP check logic if robust, or just relies on previous OS
-        // being clean)
-        if (mLimiterEnable)
-          sample = mLimiter[channel].process(sample);
+      // 8. Global Gain
+      for (UInt32 frameIndex = 0; frameIndex < frameCount; ++frameIndex)
+        out[frameIndex] = out[frameIndex] * gainRamp[frameIndex];
+    }
+  }
 
-        // 8. Global Gain
-        out[frameIndex] = sample * mGain;
+  void stepControlRamps(AUAudioFrameCount frames) {
+    for (auto &ramp : mControlRamps) {
+      if (!ramp.active)
+        continue;
+      applyParameter(ramp.address, ramp.ramper.get());
+      ramp.ramper.stepBy(frames);
+      // A finished ramper reads exactly its goal
+      if (ramp.ramper.get() == ramp.ramper.getUIValue()) {
+        applyParameter(ramp.address, ramp.ramper.getUIValue());
+        cancelControlRamp(ramp.address);
       }
     }
   }
 
-  void handleOneEvent(AUEventSampleTime now, AURenderEvent const *event) {
-    switch (event->head.eventType) {
-    case AURenderEventParameter: {
-      handleParameterEvent(now, event->parameter);
-      break;
-    }
-    default:
-      break;
+  void cancelControlRamp(AUParameterAddress address) {
+    for (auto &ramp : mControlRamps) {
+      if (ramp.active && ramp.address == address) {
+        ramp.active = false;
+        --mActiveControlRamps;
+      }
     }
   }
 
-  void handleParameterEvent(AUEventSampleTime now,
-                            AUParameterEvent const &parameterEvent) {
-    setParameter(parameterEvent.parameterAddress, parameterEvent.value);
+public:
+  // Latest estimate of the first channel pair while pitch is enabled, in Hz
+  // (0 when unvoiced), and its clarity, 0..1. Any thread.
+  float getDetectedPitch() const {
+    return mDetectedPitch.load(std::memory_order_relaxed);
+  }
+  float getPitchConfidence() const {
+    return mPitchConfidence.load(std::memory_order_relaxed);
   }
 
-  // Latency Report (4x Oversampling + Limiter Lookahead)
-  double getLatency() {
-    // Oversampler Latency (16 samples at 1x)
+  // Convolution tail blocks dropped since initialize() because the reverb's
+  // worker missed its deadline, across every response loaded. Any thread.
+  unsigned getMissedReverbBlocks() const {
+    return mMissedReverbBlocks.load(std::memory_order_relaxed);
+  }
+
+  // Latency Report (Oversampling + Limiter Lookahead)
+  double getLatency() const {
+    // Oversampler Latency (half-band cascade round trips, at 1x)
+    // The preamp island always runs; the dynamics island only while the
+    // compressor or saturator is enabled.
+    // Read from the parameter values, so the host sees a change as soon as
+    // it is made rather than when the render thread takes it over.
+    const int factor = 1 << oversamplingIndex();
     double osLatency = 0.0;
-    if (!mOversampler.empty())
-      osLatency = mOversampler[0].getLatency();
+    if (!mPreampOversampler.empty()) {
+      osLatency = mPreampOversampler[0].getLatency(factor);
+      if (parameterFlag(AIVParameterAddressCompEnable) ||
+          parameterFlag(AIVParameterAddressSatEnable))
+        osLatency += mDynamicsOversampler[0].getLatency(factor);
+    }
 
     // Limiter Lookahead (Seconds converted to samples)
     // Actually limiter has fixed delay buffer?
@@ -670,164 +759,691 @@ public:
     double limLatency = 0.0; // Handled by limiter class? No getter yet.
     // We know mLimiterLookahead is ms.
     // latency = ms * fs / 1000.
-    double limSamples = mLimiterLookahead / 1000.0 * mSampleRate;
-
-    return osLatency + limSamples;
+    // The true-peak detector's alignment delay comes on top. A disabled
+    // limiter is skipped along with its delay line.
+    double limSamples = 0.0;
+    if (parameterFlag(AIVParameterAddressLimiterEnable))
+      limSamples = parameterValue(AIVParameterAddressLimiterLookahead) /
+                       1000.0 * mSampleRate +
+                   TruePeakLimiter::kDetectorDelay;
+
+    // PSOLA grains reach a period past their pitch mark
+    double pitchLatency = 0.0;
+    if (parameterFlag(AIVParameterAddressPitchEnable))
+      pitchLatency = PitchShifter::latency(mSampleRate);
+
+    return osLatency + limSamples + pitchLatency;
   }
 
 private:
-  void updateAutoLevel() {
-    for (auto &al : mAutoLevel)
-      al.setParameters(mAutoLevelTarget, mAutoLevelRange, mAutoLevelSpeed,
-                       mSampleRate * 4.0);
+  bool isSilent(float **inputBuffers, int frameCount) const {
+    for (int channel = 0; channel < mRenderChannelCount; ++channel) {
+      const float *in = inputBuffers[channel];
+      if (!in)
+        continue;
+      // Block peak without an early exit, so the loop vectorizes
+      float any = 0.0f;
+      for (int i = 0; i < frameCount; ++i)
+        any = std::max(any, std::fabs(in[i]));
+      if (any != 0.0f)
+        return false;
+    }
+    return true;
   }
 
-  void updatePitch() {
-    for (auto &p : mPitch)
-      p.setParameters(mPitchAmount, mPitchSpeed, mSampleRate * 4.0);
+  void resizeRenderBuffers() {
+    // Lane-interleaved span plus one planar span per lane, at the max factor
+    mOversampledSpan = (int)mMaxFramesToRender * Oversampler::kMaxFactor;
+    mOversampledBuffer.resize(mOversampledSpan * kLanes * 2);
+    mLaneBuffer.resize(mMaxFramesToRender * kLanes);
+    mPadLane.resize(mMaxFramesToRender);
+    mGainRampBuffer.resize(mMaxFramesToRender);
   }
 
-  void updateGate() {
-    for (auto &g : mGate)
-      g.setParameters(mGateThresh, mGateRange, mGateAttack, mGateHold,
-                      mGateRelease, mGateHysteresis, mSampleRate * 4.0);
+  // MARK: - Coefficient Sets
+  float parameterValue(AIVParameterAddress address) const {
+    return mParameterValues[address].load(std::memory_order_relaxed);
   }
 
-  void updateDeesser() {
-    for (auto &ds : mDeesser)
-      ds.setParameters(mDeesserThresh, mDeesserFreq, mDeesserRange,
-                       mDeesserRatio, mSampleRate * 4.0);
+  bool parameterFlag(AIVParameterAddress address) const {
+    return parameterValue(address) > 0.5f;
   }
 
-  void updateEQ() {
-    // Safety HPF: 20Hz, Q=0.707
-    for (auto &eq : mSafetyHPF)
-      eq.setParameters(ZDFFilter::HighPass, 20.0, 0.707, 0.0,
-                       mSampleRate * 4.0);
+  int oversamplingIndex() const {
+    const int index = (int)(parameterValue(AIVParameterAddressOversampling) +
+                            0.5f); // 0 = 1x, 1 = 2x, 2 = 4x, 3 = 8x
+    return std::max(0, std::min(index, 3));
+  }
 
-    // Band 1: Main HPF (User controls Freq)
-    for (auto &eq : mHPF)
-      eq.setParameters(ZDFFilter::HighPass, mEQ1Freq, 0.707, 0.0,
-                       mSampleRate * 4.0);
+  // Design a complete set on the calling (non-render) thread and hand it
+  // over. The lock only serialises designers; the render thread never takes
+  // it. The set is stamped with the automation generation it has seen, read
+  // before the values: every event up to it is in the set.
+  void publishCoefficients() {
+    std::lock_guard<std::mutex> lock(mDesignMutex);
+    CoefficientSet &set = mCoefficients.back();
+    set.eventGeneration = mEventGeneration.load(std::memory_order_acquire);
+    designCoefficients(set);
+    mCoefficients.publish();
+  }
 
-    // Band 2: Low Mid Cut (Peaking) - Using Biquad for stability
-    // CLAMP Q to avoid instability
-    double safeQ2 = std::max(0.1f, std::min(mEQ2Q, 10.0f));
-    for (auto &eq : mLowMidCut)
-      eq.calculateCoefficients(BiquadFilter::Peaking, mEQ2Freq, safeQ2,
-                               mEQ2Gain, mSampleRate * 4.0);
+  // Render thread: adopt a newly loaded impulse response. The engine it
+  // replaces is parked for the loading thread to free; while the parking
+  // slot is still taken, the new one waits a buffer.
+  void takePendingConvolution() {
+    if (mRetiredConvolution.load(std::memory_order_acquire))
+      return;
+    ConvolutionReverb *next =
+        mPendingConvolution.exchange(nullptr, std::memory_order_acq_rel);
+    if (!next)
+      return;
+    if (mConvolution)
+      mRetiredMissedBlocks += mConvolution->missedTailBlocks();
+    mRetiredConvolution.store(mConvolution.release(),
+                              std::memory_order_release);
+    mConvolution.reset(next);
+  }
 
-    // Band 3: High Shelf (Standard Biquad)
-    for (auto &eq : mEQBand3)
-      eq.calculateCoefficients(BiquadFilter::HighShelf, mEQ3Freq, mEQ3Q,
-                               mEQ3Gain, mSampleRate * 4.0);
+  // Render thread: take over the newest published set, if there is one.
+  // A set designed before the latest automation event may hold the value
+  // that event replaced, so the stages events have driven since are
+  // designed again from the current values on top of it.
+  void applyPendingCoefficients() {
+    const CoefficientSet *set = mCoefficients.acquire();
+    if (!set)
+      return;
+    applyCoefficients(*set);
+    if (set->eventGeneration <
+        mEventGeneration.load(std::memory_order_relaxed)) {
+      designCoefficients(mEventCoefficients, mEventStages);
+      applyCoefficients(mEventCoefficients, mEventStages);
+    } else {
+      mEventStages = 0;
+    }
   }
 
-  void updateFilter() {
-    // Main LPF
-    // Map Resonance (-20 to 20dB) to Q
-    // Q = 0.707 * 10^(db/20)
-    double q = 0.707 * pow(10.0, mResonance / 20.0);
+  // Render thread: an automation event has to land at its sample time, so
+  // it is designed here rather than waiting for a published set. Only the
+  // stages the parameter drives are designed and applied.
+  void applyParameter(AUParameterAddress address, AUValue value) {
+    if (address >= kParameterCount)
+      return;
+    mParameterValues[address].store(value, std::memory_order_relaxed);
+    mEventGeneration.fetch_add(1, std::memory_order_release);
+    const unsigned stages = stagesFor(address);
+    mEventStages |= stages;
+    designCoefficients(mEventCoefficients, stages);
+    applyCoefficients(mEventCoefficients, stages);
+  }
 
-    for (auto &f : mLPF)
-      f.setParameters(ZDFFilter::LowPass, mCutoff, q, 0.0, mSampleRate * 4.0);
-    // Using HighPass for LPF module? Wait. ZDFFilter::HighPass is enum 0.
-    // ZDFFilter has HighPass and Peaking.
-    // Does it support LowPass?
-    // Let's check ZDFFilter class.
+  // The stages of the set a parameter drives
+  static unsigned stagesFor(AUParameterAddress address) {
+    switch (address) {
+    case AIVParameterAddressGain:
+      return 0; // ramped per sample, not designed
+    case AIVParameterAddressBypass:
+    case AIVParameterAddressInputGain:
+    case AIVParameterAddressSaturation:
+    case AIVParameterAddressPhaseInvert:
+      return kStagePreamp;
+    case AIVParameterAddressOversampling:
+      return kStagePreamp | kStageCompressor | kStageSaturator |
+             kStageLatency;
+    case AIVParameterAddressAutoLevelTarget:
+    case AIVParameterAddressAutoLevelRange:
+    case AIVParameterAddressAutoLevelSpeed:
+      return kStageAutoLevel;
+    case AIVParameterAddressPitchAmount:
+    case AIVParameterAddressPitchSpeed:
+    case AIVParameterAddressPitchKey:
+    case AIVParameterAddressPitchScale:
+    case AIVParameterAddressPitchNotes:
+      return kStagePitch;
+    case AIVParameterAddressPitchEnable:
+      return kStagePitch | kStageLatency;
+    case AIVParameterAddressGateThresh:
+    case AIVParameterAddressGateRange:
+    case AIVParameterAddressGateAttack:
+    case AIVParameterAddressGateHold:
+    case AIVParameterAddressGateRelease:
+    case AIVParameterAddressGateHysteresis:
+    case AIVParameterAddressGateEnable:
+      return kStageGate;
+    case AIVParameterAddressDeesserThresh:
+    case AIVParameterAddressDeesserFreq:
+    case AIVParameterAddressDeesserRatio:
+    case AIVParameterAddressDeesserRange:
+    case AIVParameterAddressDeesserEnable:
+      return kStageDeesser;
+    case AIVParameterAddressEQBand1Freq:
+    case AIVParameterAddressEQBand1Gain:
+    case AIVParameterAddressEQBand1Q:
+    case AIVParameterAddressEQBand2Freq:
+    case AIVParameterAddressEQBand2Gain:
+    case AIVParameterAddressEQBand2Q:
+    case AIVParameterAddressEQBand3Freq:
+    case AIVParameterAddressEQBand3Gain:
+    case AIVParameterAddressEQBand3Q:
+    case AIVParameterAddressEQEnable:
+      return kStageEQ;
+    case AIVParameterAddressCutoff:
+    case AIVParameterAddressResonance:
+      return kStageFilter;
+    case AIVParameterAddressCompThresh:
+    case AIVParameterAddressCompRatio:
+    case AIVParameterAddressCompAttack:
+    case AIVParameterAddressCompRelease:
+    case AIVParameterAddressCompMakeup:
+    case AIVParameterAddressCompAutoMakeup:
+      return kStageCompressor;
+    case AIVParameterAddressCompEnable:
+      return kStageCompressor | kStageLatency;
+    case AIVParameterAddressSatDrive:
+    case AIVParameterAddressSatType:
+      return kStageSaturator;
+    case AIVParameterAddressSatEnable:
+      return kStageSaturator | kStageLatency;
+    case AIVParameterAddressDelayTime:
+    case AIVParameterAddressDelayFeedback:
+    case AIVParameterAddressDelayMix:
+    case AIVParameterAddressDelayEnable:
+      return kStageDelay;
+    case AIVParameterAddressReverbSize:
+    case AIVParameterAddressReverbDamp:
+    case AIVParameterAddressReverbMix:
+    case AIVParameterAddressReverbEnable:
+      return kStageReverb;
+    case AIVParameterAddressLimiterCeiling:
+    case AIVParameterAddressLimiterEnable:
+      return kStageLimiter;
+    case AIVParameterAddressLimiterLookahead:
+      return kStageLimiter | kStageLatency;
+    case AIVParameterAddressDynamicsLink:
+      return kStageCompressor | kStageLimiter;
+    default:
+      return kAllStages;
+    }
+  }
+
+  // Everything the render thread takes from the parameter values, or the
+  // given stages of it
+  void designCoefficients(CoefficientSet &set,
+                          unsigned stages = kAllStages) const {
+    const double fs = mSampleRate;
+    // Only the modules inside the islands (compressor, saturator) depend on
+    // the internal rate; the preamp is stateless.
+    const int oversampleFactor = 1 << oversamplingIndex();
+    const double internalRate = fs * oversampleFactor;
+
+    if (stages & kStagePreamp) {
+      set.bypassed = parameterFlag(AIVParameterAddressBypass);
+
+      // Preamp: y = tanh(k * x) / tanh(k)
+      const float inputGainDb = parameterValue(AIVParameterAddressInputGain);
+      set.inputGainLin = std::pow(10.0f, inputGainDb / 20.0f);
+      set.preampDrive =
+          (set.inputGainLin < 0.01f) ? 0.01f : set.inputGainLin;
+      set.preampTanhNorm = 1.0f / std::tanh(set.preampDrive);
+      set.saturation = parameterValue(AIVParameterAddressSaturation);
+      set.phaseInvert = parameterFlag(AIVParameterAddressPhaseInvert);
+      set.oversampleFactor = oversampleFactor;
+    }
+
+    if (stages & kStageAutoLevel)
+      set.autoLevel = AutoLevelLanes<kLanes>::design(
+          parameterValue(AIVParameterAddressAutoLevelTarget),
+          parameterValue(AIVParameterAddressAutoLevelRange),
+          parameterValue(AIVParameterAddressAutoLevelSpeed), fs);
+
+    if (stages & kStagePitch) {
+      set.pitchEnable = parameterFlag(AIVParameterAddressPitchEnable);
+      set.pitch = PitchShifter::design(
+          parameterValue(AIVParameterAddressPitchAmount),
+          parameterValue(AIVParameterAddressPitchSpeed),
+          parameterValue(AIVParameterAddressPitchKey),
+          parameterValue(AIVParameterAddressPitchScale),
+          parameterValue(AIVParameterAddressPitchNotes), fs);
+    }
+
+    if (stages & kStageGate) {
+      set.gateEnable = parameterFlag(AIVParameterAddressGateEnable);
+      set.gate = NoiseGateLanes<kLanes>::design(
+          parameterValue(AIVParameterAddressGateThresh),
+          parameterValue(AIVParameterAddressGateRange),
+          parameterValue(AIVParameterAddressGateAttack),
+          parameterValue(AIVParameterAddressGateHold),
+          parameterValue(AIVParameterAddressGateRelease),
+          parameterValue(AIVParameterAddressGateHysteresis), mControlInterval,
+          fs);
+    }
+
+    if (stages & kStageDeesser) {
+      set.deesserEnable = parameterFlag(AIVParameterAddressDeesserEnable);
+      set.deesser = DeesserLanes<kLanes>::design(
+          parameterValue(AIVParameterAddressDeesserThresh),
+          parameterValue(AIVParameterAddressDeesserFreq),
+          parameterValue(AIVParameterAddressDeesserRange),
+          parameterValue(AIVParameterAddressDeesserRatio), fs);
+    }
+
+    if (stages & kStageEQ) {
+      set.eqEnable = parameterFlag(AIVParameterAddressEQEnable);
+
+      // Safety HPF: 20Hz, Q=0.707
+      set.safetyHPF = ZDFFilterLanes<kLanes>::design(ZDFFilter::HighPass,
+                                                     20.0, 0.707, 0.0, fs);
+
+      // Band 1: Main HPF (User controls Freq)
+      set.hpf = ZDFFilterLanes<kLanes>::design(
+          ZDFFilter::HighPass, parameterValue(AIVParameterAddressEQBand1Freq),
+          0.707, 0.0, fs);
+
+      // Band 2: Low Mid Cut (Peaking, dynamic) - the render thread adds the
+      // CrossNormalizer's mud cut to the gain
+      // CLAMP Q to avoid instability
+      set.eq2G = DynamicEQLanes<kLanes>::designG(
+          parameterValue(AIVParameterAddressEQBand2Freq), fs);
+      set.eq2Gain = parameterValue(AIVParameterAddressEQBand2Gain);
+      set.eq2Q = std::max(
+          0.1f, std::min(parameterValue(AIVParameterAddressEQBand2Q), 10.0f));
+
+      // Band 3: High Shelf (Standard Biquad)
+      set.eqBand3 = BiquadFilter::design(
+          BiquadFilter::HighShelf,
+          parameterValue(AIVParameterAddressEQBand3Freq),
+          parameterValue(AIVParameterAddressEQBand3Q),
+          parameterValue(AIVParameterAddressEQBand3Gain), fs);
+    }
+
+    if (stages & kStageFilter) {
+      // Main LPF
+      // Map Resonance (-20 to 20dB) to Q
+      // Q = 0.707 * 10^(db/20)
+      const double resonanceDb =
+          parameterValue(AIVParameterAddressResonance);
+      const double q = 0.707 * pow(10.0, resonanceDb / 20.0);
+      set.lpf = ZDFFilterLanes<kLanes>::design(
+          ZDFFilter::LowPass, parameterValue(AIVParameterAddressCutoff), q,
+          0.0, fs);
+    }
+
+    if (stages & kStageCompressor) {
+      set.compEnable = parameterFlag(AIVParameterAddressCompEnable);
+      set.compressor = FETCompressorLanes<kLanes>::design(
+          parameterValue(AIVParameterAddressCompThresh),
+          parameterValue(AIVParameterAddressCompRatio),
+          parameterValue(AIVParameterAddressCompAttack),
+          parameterValue(AIVParameterAddressCompRelease),
+          parameterValue(AIVParameterAddressCompMakeup),
+          parameterFlag(AIVParameterAddressCompAutoMakeup),
+          parameterFlag(AIVParameterAddressDynamicsLink), internalRate);
+    }
+
+    if (stages & kStageSaturator) {
+      set.satEnable = parameterFlag(AIVParameterAddressSatEnable);
+      set.saturator = SaturatorLanes<kLanes>::design(
+          parameterValue(AIVParameterAddressSatDrive),
+          parameterValue(AIVParameterAddressSatType), internalRate);
+    }
+
+    // How long the output rings on after the input stops, by stage: the
+    // feedback tails, and the latency (oversampler history, limiter
+    // lookahead, PSOLA) plus time for the filters and envelopes to settle
+    if (stages & kStageDelay) {
+      set.delayEnable = parameterFlag(AIVParameterAddressDelayEnable);
+      set.delay = DelayLine::design(
+          parameterValue(AIVParameterAddressDelayTime),
+          parameterValue(AIVParameterAddressDelayFeedback),
+          parameterValue(AIVParameterAddressDelayMix), fs);
+      set.delayTail =
+          set.delayEnable ? DelayLine::tailSamples(set.delay) : 0.0;
+    }
+
+    if (stages & kStageReverb) {
+      set.reverbEnable = parameterFlag(AIVParameterAddressReverbEnable);
+      set.reverb = MultirateReverb::design(
+          parameterValue(AIVParameterAddressReverbSize),
+          parameterValue(AIVParameterAddressReverbDamp),
+          parameterValue(AIVParameterAddressReverbMix), fs);
+      set.reverbTail =
+          set.reverbEnable ? MultirateReverb::tailSamples(set.reverb, fs)
+                           : 0.0;
+    }
+
+    if (stages & kStageLimiter) {
+      set.limiterEnable = parameterFlag(AIVParameterAddressLimiterEnable);
+      set.dynamicsLink = parameterFlag(AIVParameterAddressDynamicsLink);
+      set.limiter = TruePeakLimiter::design(
+          parameterValue(AIVParameterAddressLimiterCeiling),
+          parameterValue(AIVParameterAddressLimiterLookahead), 100.0,
+          fs); // Fixed 100ms release
+    }
+
+    if (stages & kStageLatency)
+      set.latencyTail = getLatency() + kSettleSeconds * fs;
   }
 
-  void updateComp() {
-    for (auto &c : mCompressor) {
-      c.setAutoMakeup(mCompAutoMakeup);
-      c.setParameters(mCompThresh, mCompRatio, mCompAttack, mCompRelease,
-                      mCompMakeup, mSampleRate * 4.0);
+  // Render thread: copies only, no coefficient maths
+  void applyCoefficients(const CoefficientSet &set,
+                         unsigned stages = kAllStages) {
+    if (stages & kStagePreamp) {
+      mBypassed = set.bypassed;
+
+      mInputGainLin = set.inputGainLin;
+      mPreampDrive = set.preampDrive;
+      mPreampTanhNorm = set.preampTanhNorm;
+      mSaturation = set.saturation;
+      mPhaseInvert = set.phaseInvert;
+
+      if (set.oversampleFactor != mOversampleFactor) {
+        mOversampleFactor = set.oversampleFactor;
+        for (auto &os : mPreampOversampler)
+          os.setFactor(mOversampleFactor);
+        for (auto &os : mDynamicsOversampler)
+          os.setFactor(mOversampleFactor);
+      }
+    }
+
+    if (stages & kStageAutoLevel)
+      for (auto &al : mAutoLevel)
+        al.setCoefficients(set.autoLevel);
+
+    if (stages & kStagePitch) {
+      // A stale estimate would outlive the stage, and the next run would
+      // start from old buffers
+      if (mPitchEnable && !set.pitchEnable) {
+        for (auto &d : mPitchDetector)
+          d.reset();
+        for (auto &p : mPitch)
+          p.reset();
+        mDetectedPitch.store(0.0f, std::memory_order_relaxed);
+        mPitchConfidence.store(0.0f, std::memory_order_relaxed);
+      }
+      mPitchEnable = set.pitchEnable;
+      for (auto &p : mPitch)
+        p.setCoefficients(set.pitch);
+    }
+
+    if (stages & kStageGate) {
+      mGateEnable = set.gateEnable;
+      for (auto &g : mGate)
+        g.setCoefficients(set.gate);
+    }
+
+    if (stages & kStageDeesser) {
+      mDeesserEnable = set.deesserEnable;
+      for (auto &ds : mDeesser)
+        ds.setCoefficients(set.deesser);
+    }
+
+    if (stages & kStageEQ) {
+      mEQEnable = set.eqEnable;
+      for (auto &eq : mSafetyHPF)
+        eq.setCoefficients(set.safetyHPF);
+      for (auto &eq : mHPF)
+        eq.setCoefficients(set.hpf);
+      mEQ2G = set.eq2G;
+      mEQ2Gain = set.eq2Gain;
+      mEQ2Q = set.eq2Q;
+      for (int pair = 0; pair < (int)mLowMidCut.size(); ++pair)
+        mLowMidCut[pair].setTarget(
+            mEQ2G, mEQ2Q, mEQ2Gain + mNormalizerControls[pair].mudEqCut,
+            kControlRampFrames);
+      for (auto &eq : mEQBand3)
+        eq.setCoefficients(set.eqBand3);
+    }
+
+    if (stages & kStageFilter)
+      for (auto &f : mLPF)
+        f.setCoefficients(set.lpf);
+
+    if (stages & (kStageCompressor | kStageSaturator))
+      setDynamicsEnables(
+          stages & kStageCompressor ? set.compEnable : mCompEnable,
+          stages & kStageSaturator ? set.satEnable : mSatEnable);
+    if (stages & kStageCompressor)
+      for (auto &c : mCompressor)
+        c.setCoefficients(set.compressor);
+    if (stages & kStageSaturator)
+      for (auto &s : mSaturator)
+        s.setCoefficients(set.saturator);
+
+    if (stages & kStageDelay) {
+      mDelayEnable = set.delayEnable;
+      mDelayTail = set.delayTail;
+      for (auto &d : mDelay)
+        d.setCoefficients(set.delay);
+    }
+
+    if (stages & kStageReverb) {
+      mReverbEnable = set.reverbEnable;
+      mReverbMix = set.reverb.mix;
+      mReverbTail = set.reverbTail;
+      for (auto &r : mReverb)
+        r.setCoefficients(set.reverb);
+    }
+
+    if (stages & kStageLimiter) {
+      mLimiterEnable = set.limiterEnable;
+      const bool relink = set.dynamicsLink != mDynamicsLink;
+      mDynamicsLink = set.dynamicsLink;
+      for (auto &l : mLimiter)
+        l.setCoefficients(set.limiter);
+      mLinkedLimiter.setCoefficients(set.limiter);
+      if (relink)
+        handOverLimiter();
     }
+
+    if (stages & kStageLatency)
+      mLatencyTail = set.latencyTail;
   }
 
-  void updateDelay() {
-    for (auto &d : mDelay)
-      d.setParameters(mDelayTime, mDelayFeedback, mDelayMix, mSampleRate);
+  // Render thread, on a dynamics link change: the incoming limiter carries
+  // on from the outgoing one. Linking takes the gain of the channel under
+  // most reduction; unlinking gives every channel the shared gain.
+  void handOverLimiter() {
+    const int count = (int)mLimiter.size();
+    if (mDynamicsLink) {
+      int deepest = 0;
+      for (int channel = 1; channel < count; ++channel)
+        if (mLimiter[channel].heldGain() < mLimiter[deepest].heldGain())
+          deepest = channel;
+      if (count > 0)
+        mLinkedLimiter.continueFrom(mLimiter[deepest]);
+      for (int channel = 0; channel < count; ++channel)
+        mLinkedLimiter.continueChannel(channel, mLimiter[channel], 0);
+    } else {
+      for (int channel = 0; channel < count; ++channel) {
+        mLimiter[channel].continueFrom(mLinkedLimiter);
+        mLimiter[channel].continueChannel(0, mLinkedLimiter, channel);
+      }
+    }
   }
 
-  void updateReverb() {
-    for (auto &r : mReverb)
-      r.setParameters(mReverbSize, mReverbDamp, mReverbMix, mSampleRate);
+  void resetParameterValues() {
+    static const struct {
+      AIVParameterAddress address;
+      AUValue value;
+    } kDefaults[] = {
+        {AIVParameterAddressPitchAmount, 50},
+        {AIVParameterAddressPitchSpeed, 20},
+        {AIVParameterAddressPitchScale, PitchShifter::Chromatic},
+        {AIVParameterAddressPitchNotes, 4095},
+        {AIVParameterAddressAutoLevelTarget, -10},
+        {AIVParameterAddressAutoLevelRange, 12},
+        {AIVParameterAddressAutoLevelSpeed, 50},
+        {AIVParameterAddressGateThresh, -40},
+        {AIVParameterAddressGateRange, -20},
+        {AIVParameterAddressGateAttack, 1.0},
+        {AIVParameterAddressGateHold, 150},
+        {AIVParameterAddressGateRelease, 300},
+        {AIVParameterAddressGateHysteresis, 6.0},
+        {AIVParameterAddressDeesserThresh, -20},
+        {AIVParameterAddressDeesserFreq, 5000},
+        {AIVParameterAddressDeesserRatio, 5},
+        {AIVParameterAddressDeesserRange, -6.0},
+        {AIVParameterAddressEQBand1Freq, 100},
+        {AIVParameterAddressEQBand1Q, 0.7},
+        {AIVParameterAddressEQBand2Freq, 1000},
+        {AIVParameterAddressEQBand2Q, 0.7},
+        {AIVParameterAddressEQBand3Freq, 5000},
+        {AIVParameterAddressEQBand3Q, 0.7},
+        {AIVParameterAddressCompThresh, -20},
+        {AIVParameterAddressCompRatio, 2.0},
+        {AIVParameterAddressCompAttack, 10},
+        {AIVParameterAddressCompRelease, 100},
+        {AIVParameterAddressDelayTime, 0.5},
+        {AIVParameterAddressDelayFeedback, 20},
+        {AIVParameterAddressReverbSize, 0.5},
+        {AIVParameterAddressReverbDamp, 0.5},
+        {AIVParameterAddressLimiterCeiling, -0.1},
+        {AIVParameterAddressLimiterLookahead, 2.0},
+        {AIVParameterAddressCutoff, 20000},
+        {AIVParameterAddressOversampling, 2},
+    };
+    // Everything not listed (gains, mixes, enables) starts at 0
+    for (auto &value : mParameterValues)
+      value.store(0.0f, std::memory_order_relaxed);
+    for (const auto &d : kDefaults)
+      mParameterValues[d.address].store(d.value, std::memory_order_relaxed);
   }
 
-  void updateLimiter() {
-    for (auto &l : mLimiter)
-      l.setParameters(mLimiterCeiling, mLimiterLookahead, 100.0,
-                      mSampleRate); // Fixed 100ms release
+  // Dynamics gain laws run every mControlInterval samples (8/16/32)
+  void updateControlRate() {
+    for (auto &g : mGate)
+      g.setControlRate(mControlInterval, mControlInterpolation);
+    for (auto &al : mAutoLevel)
+      al.setControlRate(mControlInterval, mControlInterpolation);
+    for (auto &ds : mDeesser)
+      ds.setControlRate(mControlInterval, mControlInterpolation);
+    for (auto &c : mCompressor)
+      c.setControlRate(mControlInterval, mControlInterpolation);
   }
 
-  void updatePreamp() { mInputGainLin = std::pow(10.0f, mInputGainDb / 20.0f); }
+  bool isDynamicsIslandActive() const { return mCompEnable || mSatEnable; }
+
+  // The dynamics island keeps its filter history while idle; clear it when
+  // the island comes back so stale samples are not replayed.
+  void setDynamicsEnables(bool compEnable, bool satEnable) {
+    const bool wasActive = isDynamicsIslandActive();
+    mCompEnable = compEnable;
+    mSatEnable = satEnable;
+    if (!wasActive && isDynamicsIslandActive()) {
+      for (auto &os : mDynamicsOversampler)
+        os.reset();
+    }
+  }
 
   // MARK: Member Variables
   AUHostMusicalContextBlock mMusicalContextBlock;
 
   double mSampleRate = 44100.0;
-  double mGain = 0.5;
+  ParameterRamper mGainRamper{0.5f};
+  AUAudioFrameCount mDezipperFrames = 882;
   bool mBypassed = false;
 
+  // Silence detection: input frames silent in a row against the frames the
+  // chain rings on; past the tail, renders skip the chain
+  static constexpr double kSettleSeconds = 0.1;
+  double mLatencyTail = 0.0, mDelayTail = 0.0, mReverbTail = 0.0;
+  double mSilentFrames = 0.0;
+  bool mSleeping = false;
+
+  // Ramps on coefficient parameters, stepped every kControlRampFrames
+  struct ControlRamp {
+    AUParameterAddress address = 0;
+    ParameterRamper ramper{0.0f};
+    bool active = false;
+  };
+  static constexpr int kMaxControlRamps = 8;
+  static constexpr AUAudioFrameCount kControlRampFrames = 32;
+  ControlRamp mControlRamps[kMaxControlRamps];
+  int mActiveControlRamps = 0;
+
+  // Parameter values by address, the source every coefficient set is
+  // designed from. Written by the UI thread and by automation events.
+  std::atomic<float> mParameterValues[kParameterCount];
+  std::mutex mDesignMutex;
+  TripleBuffer<CoefficientSet> mCoefficients;
+  CoefficientSet mEventCoefficients; // Render thread only
+  // Automation events so far, written by the render thread only, and the
+  // stages they have driven since a published set last covered them all
+  std::atomic<size_t> mEventGeneration{0};
+  unsigned mEventStages = 0;
+
   // Preamp State
-  float mInputGainDb = 0.0f;
   float mInputGainLin = 1.0f;
+  float mPreampDrive = 1.0f;
+  float mPreampTanhNorm = 1.0f;
   float mSaturation = 0.0f;
   bool mPhaseInvert = false;
 
+  // Dynamics control rate
+  int mControlInterval = 16;
+  ControlRateGain::Interpolation mControlInterpolation =
+      ControlRateGain::Linear;
+
+  // Oversampling factor (1x/2x/4x/8x)
+  int mOversampleFactor = 4;
+
   AUAudioFrameCount mMaxFramesToRender = 1024;
   int mChannelCount = 2;
 
-  // DSP Modules (Vector for multi-channel)
+  // Host buffers of the current render call (see beginRender)
+  float *mInputBuffers[kMaxChannels] = {};
+  float *mOutputBuffers[kMaxChannels] = {};
+  int mRenderChannelCount = 0;
+
+  // DSP Modules (lane modules per channel pair, the rest per channel)
   std::vector<PitchShifter> mPitch;
-  std::vector<AutoLevel> mAutoLevel;
-  std::vector<NoiseGate> mGate;
-  std::vector<Deesser> mDeesser;
-  std::vector<ZDFFilter> mSafetyHPF;
-  std::vector<ZDFFilter> mHPF;
-  std::vector<BiquadFilter> mLowMidCut;
-  std::vector<BiquadFilter> mEQBand3;
-  std::vector<ZDFFilter> mLPF;
-  std::vector<FETCompressor> mCompressor;
-  std::vector<Saturator> mSaturator;
+  std::vector<PitchDetector> mPitchDetector; // one per channel pair
+  std::atomic<float> mDetectedPitch{0.0f};
+  std::atomic<float> mPitchConfidence{0.0f};
+  std::vector<AutoLevelLanes<kLanes>> mAutoLevel;
+  std::vector<NoiseGateLanes<kLanes>> mGate;
+  std::vector<DeesserLanes<kLanes>> mDeesser;
+  std::vector<ZDFFilterLanes<kLanes>> mSafetyHPF;
+  std::vector<ZDFFilterLanes<kLanes>> mHPF;
+  std::vector<DynamicEQLanes<kLanes>> mLowMidCut;
+  std::vector<BiquadLanes<kLanes>> mEQBand3;
+  std::vector<ZDFFilterLanes<kLanes>> mLPF;
+  std::vector<FETCompressorLanes<kLanes>> mCompressor;
+  std::vector<SaturatorLanes<kLanes>> mSaturator;
   std::vector<DelayLine> mDelay;
-  std::vector<FDNReverb> mReverb;
-  std::vector<Oversampler> mOversampler;
-  std::vector<CrossNormalizer> mNormalizer;
+  std::vector<MultirateReverb> mReverb;
+  // Loaded impulse response (render thread), the one waiting to take over
+  // and the one it replaced, waiting to be freed (see loadImpulseResponse)
+  std::unique_ptr<ConvolutionReverb> mConvolution;
+  std::atomic<ConvolutionReverb *> mPendingConvolution{nullptr};
+  std::atomic<ConvolutionReverb *> mRetiredConvolution{nullptr};
+  // Misses of the engines replaced so far (render thread), and the total
+  unsigned mRetiredMissedBlocks = 0;
+  std::atomic<unsigned> mMissedReverbBlocks{0};
+  float mReverbMix = 0.0f;
+  std::vector<Oversampler> mPreampOversampler;   // Island A: preamp
+  std::vector<Oversampler> mDynamicsOversampler; // Island B: comp + sat
+  std::vector<CrossNormalizer> mNormalizer; // one per channel pair, linked
+  // Controls the render thread applies, from mNormalizer or the worker
+  std::vector<CrossNormalizer::Controls> mNormalizerControls;
+  AnalysisWorker<kLanes> mAnalysisWorker;
+  bool mAsyncAnalysis = false;
   std::vector<TruePeakLimiter> mLimiter;
+  TruePeakLimiter mLinkedLimiter; // all channels, when linked
 
-  // Parameter State Cache
-  float mPitchAmount = 0;
-  float mPitchSpeed = 20;
-
-  float mAutoLevelTarget = -10, mAutoLevelRange = 12, mAutoLevelSpeed = 50;
-
-  float mGateThresh = -40, mGateRange = -20, mGateAttack = 1.0, mGateHold = 150,
-        mGateRelease = 300, mGateHysteresis = 6.0;
-
-  float mDeesserThresh = -20, mDeesserFreq = 5000, mDeesserRatio = 5,
-        mDeesserRange = -6.0;
-
-  float mEQ1Freq = 100, mEQ1Gain = 0, mEQ1Q = 0.7;
-  float mEQ2Freq = 1000, mEQ2Gain = 0, mEQ2Q = 0.7;
-  float mEQ3Freq = 5000, mEQ3Gain = 0, mEQ3Q = 0.7;
-
-  float mCompThresh = -20, mCompRatio = 2.0, mCompAttack = 10,
-        mCompRelease = 100, mCompMakeup = 0;
-  bool mCompAutoMakeup = false;
-
-  float mSatDrive = 0, mSatType = 0;
-
-  float mDelayTime = 0.5, mDelayFeedback = 20, mDelayMix = 0;
-
-  float mReverbSize = 0.5f, mReverbDamp = 0.5f, mReverbMix = 0.0f;
-  float mLimiterCeiling = -0.1f, mLimiterLookahead = 2.0f;
-
-  float mCutoff = 20000.0f;
-  float mResonance = 0.0f;
+  // EQ band 2 base settings; the mud cut is added per channel
+  double mEQ2G = 0.0;
+  float mEQ2Gain = 0, mEQ2Q = 0.7;
 
   std::vector<float> mScratchBuffer;
+  // Island scratch: one channel pair at the oversampled rate, interleaved,
+  // followed by a planar span per lane
+  std::vector<float> mOversampledBuffer;
+  int mOversampledSpan = 0;
+  // One channel pair at 1x, interleaved, and a silent pad for missing lanes
+  std::vector<float> mLaneBuffer;
+  std::vector<float> mPadLane;
+  // Per-sample output gain for the current slice
+  std::vector<float> mGainRampBuffer;
 
   // Module Enables (Default OFF)
   bool mGateEnable = false;
@@ -839,4 +1455,6 @@ private:
   bool mReverbEnable = false;
   bool mPitchEnable = false;
   bool mLimiterEnable = false;
+  // Compressor (per pair) and limiter (whole bus) share one gain
+  bool mDynamicsLink = false;
 };
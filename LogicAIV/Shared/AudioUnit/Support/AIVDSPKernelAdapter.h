@@ -61,6 +61,11 @@ typedef NS_ENUM(AUParameterAddress, AIVParameterAddress) {
   AIVParameterAddressCutoff = 50,
   AIVParameterAddressResonance = 51,
 
+  // Pitch Correction
+  AIVParameterAddressPitchKey = 55,
+  AIVParameterAddressPitchScale = 56,
+  AIVParameterAddressPitchNotes = 57,
+
   AIVParameterAddressInputGain = 34,
   AIVParameterAddressSaturation = 35,
   AIVParameterAddressPhaseInvert = 36,
@@ -69,6 +74,7 @@ typedef NS_ENUM(AUParameterAddress, AIVParameterAddress) {
   AIVParameterAddressLimiterCeiling = 60,
   AIVParameterAddressLimiterLookahead = 61,
   AIVParameterAddressCompAutoMakeup = 62,
+  AIVParameterAddressDynamicsLink = 63,
 
   // Module Enables
   AIVParameterAddressGateEnable = 70,
@@ -79,10 +85,14 @@ typedef NS_ENUM(AUParameterAddress, AIVParameterAddress) {
   AIVParameterAddressDelayEnable = 75,
   AIVParameterAddressReverbEnable = 76,
   AIVParameterAddressPitchEnable = 77,
-  AIVParameterAddressLimiterEnable = 78
+  AIVParameterAddressLimiterEnable = 78,
+
+  // Quality
+  AIVParameterAddressOversampling = 80
 };
 
 @class AIVDemoViewController;
+@class AVAudioPCMBuffer;
 
 NS_ASSUME_NONNULL_BEGIN
 
@@ -92,6 +102,22 @@ NS_ASSUME_NONNULL_BEGIN
 @property(nonatomic) AUAudioFrameCount maximumFramesToRender;
 @property(nonatomic, readonly) AUAudioUnitBus *inputBus;
 @property(nonatomic, readonly) AUAudioUnitBus *outputBus;
+@property(nonatomic, readonly) NSTimeInterval latency;
+// Fundamental of the input while pitch is enabled, in Hz (0 when unvoiced),
+// and the detector's confidence in it, 0..1
+@property(nonatomic, readonly) float detectedPitch;
+@property(nonatomic, readonly) float pitchConfidence;
+// Convolution reverb tail blocks dropped since render resources were
+// allocated because its worker thread fell behind; each is a gap in the
+// reverb tail, like an xrun
+@property(nonatomic, readonly) NSUInteger missedReverbBlocks;
+// Run the CrossNormalizer analysis on a background thread. Set before
+// allocating render resources.
+@property(nonatomic) BOOL asyncAnalysis;
+
+// Use a convolution reverb with this impulse response (deinterleaved float,
+// at the session rate) in place of the algorithmic one; nil goes back.
+- (void)loadImpulseResponse:(nullable AVAudioPCMBuffer *)impulseResponse;
 
 - (void)setParameter:(AUParameter *)parameter value:(AUValue)value;
 - (AUValue)valueForParameter:(AUParameter *)parameter;
@@ -83,6 +83,42 @@ DSP code.
   _kernel.setMaximumFramesToRender(maximumFramesToRender);
 }
 
+- (BOOL)asyncAnalysis {
+  return _kernel.isAsyncAnalysis();
+}
+
+- (void)setAsyncAnalysis:(BOOL)asyncAnalysis {
+  _kernel.setAsyncAnalysis(asyncAnalysis);
+}
+
+- (void)loadImpulseResponse:(AVAudioPCMBuffer *)impulseResponse {
+  float *const *channels = impulseResponse.floatChannelData;
+  if (!channels || impulseResponse.stride != 1) {
+    _kernel.loadImpulseResponse(nullptr, 0, 0);
+    return;
+  }
+  _kernel.loadImpulseResponse(channels,
+                              (int)impulseResponse.format.channelCount,
+                              (int)impulseResponse.frameLength);
+}
+
+- (NSTimeInterval)latency {
+  // Kernel reports samples at the host rate
+  return _kernel.getLatency() / self.outputBus.format.sampleRate;
+}
+
+- (float)detectedPitch {
+  return _kernel.getDetectedPitch();
+}
+
+- (float)pitchConfidence {
+  return _kernel.getPitchConfidence();
+}
+
+- (NSUInteger)missedReverbBlocks {
+  return _kernel.getMissedReverbBlocks();
+}
+
 - (void)allocateRenderResources {
   _inputBus.allocateRenderResources(self.maximumFramesToRender);
   _kernel.initialize(self.outputBus.format.channelCount,
@@ -92,6 +128,7 @@ DSP code.
 
 - (void)deallocateRenderResources {
   _inputBus.deallocateRenderResources();
+  _kernel.deInitialize();
 }
 
 #pragma mark - AUAudioUnit (AUAudioUnitImplementation)
@@ -112,6 +149,9 @@ DSP code.
       AVAudioFrameCount frameCount, NSInteger outputBusNumber,
       AudioBufferList *outputData, const AURenderEvent *realtimeEventListHead,
       AURenderPullInputBlock pullInputBlock) {
+    // Decaying tails must not fall into the slow subnormal range; the
+    // host's floating-point mode is restored on return
+    ScopedNoDenormals noDenormals;
     AudioUnitRenderActionFlags pullFlags = 0;
 
     if (frameCount > state->maximumFramesToRender()) {
@@ -135,21 +175,17 @@ DSP code.
       }
     }
 
-    // Process Events
-    const AURenderEvent *event = realtimeEventListHead;
-    while (event != nullptr) {
-      state->handleOneEvent(timestamp->mSampleTime, event);
-      event = event->head.next;
-    }
-
-    // Bridge AudioBufferList to std::vector or raw pointers for C++ kernel
-    int inputChannelCount =
-        inAudioBufferList
-            ->mNumberBuffers; // Should be 2 (Planar) via BufferedBus
-    int outputBufferCount = outAudioBufferList->mNumberBuffers;
+    // Bridge AudioBufferList to raw pointers for C++ kernel; buses wider
+    // than the kernel renders are clamped rather than overrun
+    const int inputChannelCount =
+        std::min((int)inAudioBufferList->mNumberBuffers,
+                 (int)AIVDSPKernel::kMaxChannels); // 2 (Planar) via BufferedBus
+    const int outputBufferCount =
+        std::min((int)outAudioBufferList->mNumberBuffers,
+                 (int)AIVDSPKernel::kMaxChannels);
 
-    float *inputChannels[inputChannelCount];
-    float *outputChannels[2]; // Max 2 channels for this plugin
+    float *inputChannels[AIVDSPKernel::kMaxChannels] = {};
+    float *outputChannels[AIVDSPKernel::kMaxChannels] = {};
 
     for (int i = 0; i < inputChannelCount; ++i) {
       inputChannels[i] = (float *)inAudioBufferList->mBuffers[i].mData;
@@ -172,9 +208,19 @@ DSP code.
     }
 
     // Process (Planar inputs -> Planar outputs (scratch or direct))
-    state->process(inputChannels, outputChannels, timestamp->mSampleTime,
-                   frameCount,
-                   inputChannelCount); // Use input channel count (2)
+    // The buffer is rendered in slices split at each event's sample time, so
+    // parameter changes and ramps land sample-accurately.
+    // Upstream silence lets the kernel skip scanning the input
+    const bool inputSilent =
+        (pullFlags & kAudioUnitRenderAction_OutputIsSilence) != 0;
+    state->beginRender(inputChannels, outputChannels, frameCount,
+                       inputChannelCount, // Use input channel count (2)
+                       inputSilent);
+    state->processWithEvents(timestamp, frameCount, realtimeEventListHead,
+                             nil);
+    // Past its tail the kernel wrote zeros; downstream may skip them too
+    if (state->isOutputSilent())
+      *actionFlags |= kAudioUnitRenderAction_OutputIsSilence;
 
     // Handle Interleaved Output (mix planar scratch back to interleaved output)
     if (outputIsInterleaved) {
@@ -0,0 +1,899 @@
+//
+//  AIVDSPLanes.hpp
+//  AIVExtension
+//
+//  Created by AIV on 02/02/2026.
+//
+
+#pragma once
+
+#import "AIVDSPClasses.hpp"
+
+// --- Multi-Channel (SoA) Variants ---
+// Each class below runs `Lanes` channels (2, 4 or 8) of one module in a
+// single pass. Per-channel state lives in arrays indexed by lane, and audio is
+// frame-interleaved (x[frame * Lanes + lane]), so the innermost loop is a
+// fixed-width loop over lanes that the compiler maps onto SIMD registers.
+// The maths matches the scalar classes in AIVDSPClasses.hpp; the scalar
+// classes remain the reference (and the per-sample API).
+
+template <int Lanes> struct LaneWidth {
+  static_assert(Lanes == 2 || Lanes == 4 || Lanes == 8,
+                "Lane count must be 2, 4 or 8");
+};
+
+// Planar channel pointers <-> frame-interleaved lanes
+template <int Lanes>
+inline void interleaveLanes(float *const *channels, float *lanes,
+                            int numFrames) {
+  for (int i = 0; i < numFrames; ++i)
+    for (int c = 0; c < Lanes; ++c)
+      lanes[i * Lanes + c] = channels[c][i];
+}
+
+template <int Lanes>
+inline void deinterleaveLanes(const float *lanes, float *const *channels,
+                              int numFrames) {
+  for (int i = 0; i < numFrames; ++i)
+    for (int c = 0; c < Lanes; ++c)
+      channels[c][i] = lanes[i * Lanes + c];
+}
+
+// --- Biquad (Lanes) ---
+// Coefficients are per lane so that each channel can be tuned on its own
+// (e.g. the CrossNormalizer's per-channel mud cut).
+template <int Lanes> class BiquadLanes : LaneWidth<Lanes> {
+public:
+  void setCoefficients(const BiquadFilter::Coefficients &coeffs) {
+    for (int c = 0; c < Lanes; ++c)
+      setCoefficients(c, coeffs);
+  }
+
+  void setCoefficients(int lane, const BiquadFilter::Coefficients &coeffs) {
+    b0[lane] = coeffs.b0;
+    b1[lane] = coeffs.b1;
+    b2[lane] = coeffs.b2;
+    a1[lane] = coeffs.a1;
+    a2[lane] = coeffs.a2;
+  }
+
+  void calculateCoefficients(BiquadFilter::Type type, double freq, double Q,
+                             double dbGain, double sampleRate) {
+    setCoefficients(BiquadFilter::design(type, freq, Q, dbGain, sampleRate));
+  }
+
+  void calculateCoefficients(int lane, BiquadFilter::Type type, double freq,
+                             double Q, double dbGain, double sampleRate) {
+    setCoefficients(lane,
+                    BiquadFilter::design(type, freq, Q, dbGain, sampleRate));
+  }
+
+  void reset() {
+    for (int c = 0; c < Lanes; ++c)
+      x1[c] = x2[c] = y1[c] = y2[c] = 0.0;
+  }
+
+  void processBlock(float *x, int numFrames) {
+    for (int i = 0; i < numFrames; ++i) {
+      float *frame = x + i * Lanes;
+      for (int c = 0; c < Lanes; ++c) {
+        const double in = frame[c];
+        const double out =
+            flushDenormal(b0[c] * in + b1[c] * x1[c] + b2[c] * x2[c] -
+                          a1[c] * y1[c] - a2[c] * y2[c]);
+        x2[c] = x1[c];
+        x1[c] = in;
+        y2[c] = y1[c];
+        y1[c] = out;
+        frame[c] = (float)out;
+      }
+    }
+  }
+
+private:
+  alignas(64) double b0[Lanes] = {}, b1[Lanes] = {}, b2[Lanes] = {};
+  alignas(64) double a1[Lanes] = {}, a2[Lanes] = {};
+  alignas(64) double x1[Lanes] = {}, x2[Lanes] = {};
+  alignas(64) double y1[Lanes] = {}, y2[Lanes] = {};
+};
+
+// --- ZDF Filter (Lanes) ---
+// Same TPT SVF as ZDFFilter with shared settings. The response type is
+// folded into output weights so the lane loop has no branches.
+template <int Lanes> class ZDFFilterLanes : LaneWidth<Lanes> {
+public:
+  struct Coefficients {
+    double g = 0.0, k = 0.0, invDen = 1.0;
+    double wIn = 0.0, wHp = 1.0, wBp = 0.0, wLp = 0.0;
+  };
+
+  static Coefficients design(ZDFFilter::Type type, double freq, double Q,
+                             double gainDb, double sampleRate) {
+    Coefficients c;
+    c.g = std::tan(kPi * freq / sampleRate);
+    if (Q < 0.1)
+      Q = 0.1;
+    const double R = 1.0 / (2.0 * Q);
+    c.k = 2.0 * R + c.g;
+    c.invDen = 1.0 / (1.0 + 2.0 * R * c.g + c.g * c.g);
+
+    const double A = std::pow(10.0, gainDb / 40.0);
+    c.wIn = c.wHp = c.wBp = c.wLp = 0.0;
+    switch (type) {
+    case ZDFFilter::HighPass:
+      c.wHp = 1.0;
+      break;
+    case ZDFFilter::LowPass:
+      c.wLp = 1.0;
+      break;
+    case ZDFFilter::Peaking:
+      // input + (A^2 - 1) * normalized bandpass
+      c.wIn = 1.0;
+      c.wBp = (A * A - 1.0) * 2.0 * R;
+      break;
+    }
+    return c;
+  }
+
+  void setCoefficients(const Coefficients &c) {
+    g = c.g;
+    k = c.k;
+    invDen = c.invDen;
+    wIn = c.wIn;
+    wHp = c.wHp;
+    wBp = c.wBp;
+    wLp = c.wLp;
+  }
+
+  void setParameters(ZDFFilter::Type type, double freq, double Q,
+                     double gainDb, double sampleRate) {
+    setCoefficients(design(type, freq, Q, gainDb, sampleRate));
+  }
+
+  void reset() {
+    for (int c = 0; c < Lanes; ++c)
+      s1[c] = s2[c] = 0.0;
+  }
+
+  void processBlock(float *x, int numFrames) {
+    for (int i = 0; i < numFrames; ++i) {
+      float *frame = x + i * Lanes;
+      for (int c = 0; c < Lanes; ++c) {
+        const double in = frame[c];
+        const double hp = (in - k * s1[c] - s2[c]) * invDen;
+        const double bp = g * hp + s1[c];
+        const double lp = g * bp + s2[c];
+        s1[c] = flushDenormal(2.0 * bp - s1[c]);
+        s2[c] = flushDenormal(2.0 * lp - s2[c]);
+        frame[c] = (float)(wIn * in + wHp * hp + wBp * bp + wLp * lp);
+      }
+    }
+  }
+
+private:
+  double g = 0.0, k = 0.0, invDen = 1.0;
+  double wIn = 0.0, wHp = 1.0, wBp = 0.0, wLp = 0.0;
+  alignas(64) double s1[Lanes] = {}, s2[Lanes] = {};
+};
+
+// --- Dynamic EQ Band (Lanes) ---
+// Peaking band whose gain is moved at runtime (the CrossNormalizer mud cut),
+// per lane or linked across the lanes. It runs as a TPT state-variable
+// filter (Cytomic form): with g = tan(w0 / 2) and k = 1 / (Q * A) the bell
+// matches the RBJ peaking biquad exactly, but g, k and the band gain m1 can
+// be swept sample by sample without the state blowing up or clicking, which
+// a biquad's direct-form coefficients cannot.
+// A new target is only taken when the gain has moved by at least
+// kGainThresholdDb since the last one (or the frequency / Q changed); the
+// filter then ramps linearly to it over the given number of frames.
+template <int Lanes> class DynamicEQLanes : LaneWidth<Lanes> {
+public:
+  static constexpr float kGainThresholdDb = 0.05f;
+
+  // Frequency-dependent part; the only transcendental in the design, so it
+  // is done with the rest of the coefficient set, off the render thread
+  static double designG(double freq, double sampleRate) {
+    return std::tan(kPi * freq / sampleRate);
+  }
+
+  DynamicEQLanes() {
+    for (int c = 0; c < Lanes; ++c) {
+      targetDb[c] = 0.0f;
+      g[c] = gTarget[c] = designG(1000.0, 44100.0);
+      k[c] = kTarget[c] = 1.0 / 0.7;
+      m1[c] = m1Target[c] = 0.0;
+      dg[c] = dk[c] = dm1[c] = 0.0;
+    }
+    updateTaps();
+  }
+
+  void setTarget(int lane, double g, double Q, float gainDb, int rampFrames) {
+    if (retarget(lane, g, Q, gainDb))
+      startRamp(rampFrames);
+  }
+
+  // Linked: every lane takes the same target
+  void setTarget(double g, double Q, float gainDb, int rampFrames) {
+    bool moved = false;
+    for (int c = 0; c < Lanes; ++c)
+      moved |= retarget(c, g, Q, gainDb);
+    if (moved)
+      startRamp(rampFrames);
+  }
+
+  // Jump to the targets and clear the state
+  void reset() {
+    rampRemaining = 0;
+    for (int c = 0; c < Lanes; ++c) {
+      g[c] = gTarget[c];
+      k[c] = kTarget[c];
+      m1[c] = m1Target[c];
+      ic1[c] = ic2[c] = 0.0;
+    }
+    updateTaps();
+  }
+
+  void processBlock(float *x, int numFrames) {
+    int i = 0;
+    // Ramping: the taps follow g and k every sample
+    for (; i < numFrames && rampRemaining > 0; ++i, --rampRemaining) {
+      float *frame = x + i * Lanes;
+      for (int c = 0; c < Lanes; ++c) {
+        g[c] += dg[c];
+        k[c] += dk[c];
+        m1[c] += dm1[c];
+        a1[c] = 1.0 / (1.0 + g[c] * (g[c] + k[c]));
+        a2[c] = g[c] * a1[c];
+        a3[c] = g[c] * a2[c];
+        frame[c] = tick(c, frame[c]);
+      }
+    }
+    if (rampRemaining == 0 && i > 0)
+      settle();
+
+    for (; i < numFrames; ++i) {
+      float *frame = x + i * Lanes;
+      for (int c = 0; c < Lanes; ++c)
+        frame[c] = tick(c, frame[c]);
+    }
+  }
+
+private:
+  float tick(int c, float in) {
+    const double v0 = in;
+    const double v3 = v0 - ic2[c];
+    const double v1 = a1[c] * ic1[c] + a2[c] * v3;
+    const double v2 = ic2[c] + a2[c] * ic1[c] + a3[c] * v3;
+    ic1[c] = flushDenormal(2.0 * v1 - ic1[c]);
+    ic2[c] = flushDenormal(2.0 * v2 - ic2[c]);
+    return (float)(v0 + m1[c] * v1);
+  }
+
+  bool retarget(int lane, double g, double Q, float gainDb) {
+    if (g == gBase[lane] && Q == qBase[lane] &&
+        std::fabs(gainDb - targetDb[lane]) < kGainThresholdDb)
+      return false;
+    gBase[lane] = g;
+    qBase[lane] = Q;
+    targetDb[lane] = gainDb;
+
+    const double A = FastMath::dbToLin(0.5f * gainDb); // 10^(dB / 40)
+    gTarget[lane] = g;
+    kTarget[lane] = 1.0 / (Q * A);
+    m1Target[lane] = kTarget[lane] * (A * A - 1.0);
+    return true;
+  }
+
+  // All lanes share one ramp; lanes whose target did not move ramp by zero
+  void startRamp(int rampFrames) {
+    if (rampFrames <= 0) {
+      reset();
+      return;
+    }
+    const double inv = 1.0 / (double)rampFrames;
+    for (int c = 0; c < Lanes; ++c) {
+      dg[c] = (gTarget[c] - g[c]) * inv;
+      dk[c] = (kTarget[c] - k[c]) * inv;
+      dm1[c] = (m1Target[c] - m1[c]) * inv;
+    }
+    rampRemaining = rampFrames;
+  }
+
+  // Land exactly on the targets once a ramp ends
+  void settle() {
+    for (int c = 0; c < Lanes; ++c) {
+      g[c] = gTarget[c];
+      k[c] = kTarget[c];
+      m1[c] = m1Target[c];
+    }
+    updateTaps();
+  }
+
+  void updateTaps() {
+    for (int c = 0; c < Lanes; ++c) {
+      a1[c] = 1.0 / (1.0 + g[c] * (g[c] + k[c]));
+      a2[c] = g[c] * a1[c];
+      a3[c] = g[c] * a2[c];
+    }
+  }
+
+  int rampRemaining = 0;
+  alignas(64) double g[Lanes], k[Lanes], m1[Lanes];
+  alignas(64) double dg[Lanes], dk[Lanes], dm1[Lanes];
+  alignas(64) double a1[Lanes], a2[Lanes], a3[Lanes];
+  alignas(64) double ic1[Lanes] = {}, ic2[Lanes] = {};
+  double gTarget[Lanes], kTarget[Lanes], m1Target[Lanes];
+  double gBase[Lanes] = {}, qBase[Lanes] = {};
+  float targetDb[Lanes];
+};
+
+// --- Noise Gate (Lanes) ---
+template <int Lanes> class NoiseGateLanes : LaneWidth<Lanes> {
+public:
+  NoiseGateLanes() {
+    for (auto &gc : gainControl)
+      gc.reset(0.0f);
+  }
+
+  // attackCoeffN / releaseCoeffN are the per-segment coefficients for the
+  // given control interval
+  struct Coefficients {
+    double openThreshold = 0.0, closeThreshold = 0.0, rangeFactor = 0.0;
+    double attackCoeff = 0.0, releaseCoeff = 0.0;
+    double attackCoeffN = 0.0, releaseCoeffN = 0.0;
+    int holdSamples = 0;
+  };
+
+  static Coefficients design(double thresholdDb, double rangeDb,
+                             double attackMs, double holdMs, double releaseMs,
+                             double hysteresisDb, int controlInterval,
+                             double sampleRate) {
+    Coefficients c;
+    c.openThreshold = pow(10.0, thresholdDb / 20.0);
+    c.closeThreshold = pow(10.0, (thresholdDb - hysteresisDb) / 20.0);
+    c.rangeFactor = pow(10.0, rangeDb / 20.0);
+    c.attackCoeff = exp(-1.0 / (sampleRate * attackMs / 1000.0));
+    c.releaseCoeff = exp(-1.0 / (sampleRate * releaseMs / 1000.0));
+    c.holdSamples = (int)(holdMs / 1000.0 * sampleRate);
+    c.attackCoeffN = pow(c.attackCoeff, controlInterval);
+    c.releaseCoeffN = pow(c.releaseCoeff, controlInterval);
+    return c;
+  }
+
+  void setCoefficients(const Coefficients &c) {
+    openThreshold = c.openThreshold;
+    closeThreshold = c.closeThreshold;
+    rangeFactor = c.rangeFactor;
+    attackCoeff = c.attackCoeff;
+    releaseCoeff = c.releaseCoeff;
+    attackCoeffN = c.attackCoeffN;
+    releaseCoeffN = c.releaseCoeffN;
+    holdSamples = c.holdSamples;
+  }
+
+  void setParameters(double thresholdDb, double rangeDb, double attackMs,
+                     double holdMs, double releaseMs, double hysteresisDb,
+                     double sampleRate) {
+    setCoefficients(design(thresholdDb, rangeDb, attackMs, holdMs, releaseMs,
+                           hysteresisDb, gainControl[0].getInterval(),
+                           sampleRate));
+  }
+
+  void setControlRate(int interval, ControlRateGain::Interpolation mode) {
+    for (auto &gc : gainControl) {
+      gc.setInterval(interval);
+      gc.setInterpolation(mode);
+    }
+    updateControlCoeffs();
+  }
+
+  void processBlock(float *x, int numFrames) {
+    const int interval = gainControl[0].getInterval();
+    for (int start = 0; start < numFrames; start += interval) {
+      const int n = std::min(interval, numFrames - start);
+      float *seg = x + start * Lanes;
+
+      alignas(64) double peak[Lanes] = {};
+      for (int i = 0; i < n; ++i) {
+        const float *frame = seg + i * Lanes;
+        for (int c = 0; c < Lanes; ++c) {
+          const double absInput = std::fabs(frame[c]);
+          const double coeff =
+              absInput > envelope[c] ? attackCoeff : releaseCoeff;
+          envelope[c] = coeff * (envelope[c] - absInput) + absInput;
+          peak[c] = std::max(peak[c], envelope[c]);
+        }
+      }
+
+      for (int c = 0; c < Lanes; ++c) {
+        advanceControl(c, peak[c], n);
+        gainControl[c].beginSegment((float)currentGain[c]);
+      }
+
+      applyGain(seg, n);
+    }
+  }
+
+  bool isOpen(int lane) const { return isGateOpen[lane]; }
+
+private:
+  void advanceControl(int c, double segmentPeak, int n) {
+    if (isGateOpen[c]) {
+      if (envelope[c] < closeThreshold) {
+        if (holdCounter[c] >= holdSamples)
+          isGateOpen[c] = false;
+        else
+          holdCounter[c] += n;
+      } else {
+        holdCounter[c] = 0;
+      }
+    } else if (segmentPeak > openThreshold) {
+      isGateOpen[c] = true;
+      holdCounter[c] = 0;
+    }
+
+    const bool full = (n == gainControl[c].getInterval());
+    const double targetGain = isGateOpen[c] ? 1.0 : rangeFactor;
+    if (targetGain > currentGain[c]) {
+      const double coeff = full ? attackCoeffN : pow(attackCoeff, n);
+      currentGain[c] = coeff * (currentGain[c] - targetGain) + targetGain;
+    } else {
+      const double coeff = full ? releaseCoeffN : pow(releaseCoeff, n);
+      currentGain[c] = coeff * (currentGain[c] - targetGain) + targetGain;
+    }
+  }
+
+  void applyGain(float *seg, int n) {
+    const float invN = 1.0f / (float)n;
+    for (int i = 0; i < n; ++i) {
+      const float t = (float)(i + 1) * invN;
+      float *frame = seg + i * Lanes;
+      for (int c = 0; c < Lanes; ++c)
+        frame[c] *= gainControl[c].at(t);
+    }
+  }
+
+  void updateControlCoeffs() {
+    attackCoeffN = pow(attackCoeff, gainControl[0].getInterval());
+    releaseCoeffN = pow(releaseCoeff, gainControl[0].getInterval());
+  }
+
+  ControlRateGain gainControl[Lanes];
+  double openThreshold = 0.0, closeThreshold = 0.0, rangeFactor = 0.0;
+  double attackCoeff = 0.0, releaseCoeff = 0.0;
+  double attackCoeffN = 0.0, releaseCoeffN = 0.0;
+  int holdSamples = 0;
+
+  alignas(64) double envelope[Lanes] = {};
+  double currentGain[Lanes] = {};
+  bool isGateOpen[Lanes] = {};
+  int holdCounter[Lanes] = {};
+};
+
+// --- Auto Level (Lanes) ---
+template <int Lanes> class AutoLevelLanes : LaneWidth<Lanes> {
+public:
+  AutoLevelLanes() {
+    for (int c = 0; c < Lanes; ++c)
+      currentGain[c] = externalGain[c] = 1.0;
+  }
+
+  struct Coefficients {
+    double attackCoef = 0.0, releaseCoef = 0.0;
+    double targetDb = -6.0, rangeDb = 6.0;
+  };
+
+  static Coefficients design(double targetDb, double rangeDb, double speed,
+                             double sampleRate) {
+    Coefficients c;
+    c.targetDb = targetDb;
+    c.rangeDb = rangeDb;
+    double attackMs = 1000.0 - (speed * 9.0); // 100ms to 1000ms
+    double releaseMs = attackMs * 2.0;
+    c.attackCoef = exp(-1.0 / (sampleRate * attackMs / 1000.0));
+    c.releaseCoef = exp(-1.0 / (sampleRate * releaseMs / 1000.0));
+    return c;
+  }
+
+  void setCoefficients(const Coefficients &c) {
+    attackCoef = c.attackCoef;
+    releaseCoef = c.releaseCoef;
+    targetDb = c.targetDb;
+    rangeDb = c.rangeDb;
+  }
+
+  void setParameters(double targetDb, double rangeDb, double speed,
+                     double sampleRate) {
+    setCoefficients(design(targetDb, rangeDb, speed, sampleRate));
+  }
+
+  void setGainOffset(int lane, double db) {
+    externalGain[lane] = pow(10.0, db / 20.0);
+    useExternalGain[lane] = true;
+  }
+
+  void setControlRate(int interval, ControlRateGain::Interpolation mode) {
+    for (auto &gc : gainControl) {
+      gc.setInterval(interval);
+      gc.setInterpolation(mode);
+    }
+  }
+
+  // Lanes driven by the CrossNormalizer smooth towards its gain per sample;
+  // the others follow their own envelope with the gain law at control rate.
+  void processBlock(float *x, int numFrames) {
+    const int interval = gainControl[0].getInterval();
+    for (int start = 0; start < numFrames; start += interval) {
+      const int n = std::min(interval, numFrames - start);
+      float *seg = x + start * Lanes;
+
+      for (int i = 0; i < n; ++i) {
+        const float *frame = seg + i * Lanes;
+        for (int c = 0; c < Lanes; ++c) {
+          const double absInput = std::fabs(frame[c]);
+          const double coeff = absInput > envelope[c] ? attackCoef : releaseCoef;
+          envelope[c] = coeff * (envelope[c] - absInput) + absInput;
+        }
+      }
+
+      for (int c = 0; c < Lanes; ++c)
+        gainControl[c].beginSegment(computeGain(c));
+
+      const float invN = 1.0f / (float)n;
+      for (int i = 0; i < n; ++i) {
+        const float t = (float)(i + 1) * invN;
+        float *frame = seg + i * Lanes;
+        for (int c = 0; c < Lanes; ++c) {
+          currentGain[c] = attackCoef * (currentGain[c] - externalGain[c]) +
+                           externalGain[c];
+          const float g = useExternalGain[c] ? (float)currentGain[c]
+                                             : gainControl[c].at(t);
+          frame[c] *= g;
+        }
+      }
+    }
+  }
+
+private:
+  float computeGain(int c) const {
+    if (envelope[c] < 0.0001)
+      return 1.0f;
+    float gainDb = (float)targetDb - FastMath::linToDb((float)envelope[c]);
+    gainDb = std::max((float)-rangeDb, std::min(gainDb, (float)rangeDb));
+    return FastMath::dbToLin(gainDb);
+  }
+
+  ControlRateGain gainControl[Lanes];
+  double attackCoef = 0.0, releaseCoef = 0.0;
+  double targetDb = -6.0, rangeDb = 6.0;
+
+  alignas(64) double envelope[Lanes] = {};
+  alignas(64) double currentGain[Lanes];
+  alignas(64) double externalGain[Lanes];
+  bool useExternalGain[Lanes] = {};
+};
+
+// --- Deesser (Lanes) ---
+template <int Lanes> class DeesserLanes : LaneWidth<Lanes> {
+public:
+  struct Coefficients {
+    double threshold = 0.5, maxAttenuation = 0.5;
+    float grExponent = -0.8f;
+    double attack = 0.0, release = 0.0;
+    BiquadFilter::Coefficients crossover;
+  };
+
+  static Coefficients design(double thresholdDb, double frequency,
+                             double rangeDb, double ratio, double sampleRate) {
+    Coefficients c;
+    c.threshold = pow(10.0, thresholdDb / 20.0);
+    c.grExponent = (float)(1.0 / ratio - 1.0);
+    c.maxAttenuation = pow(10.0, rangeDb / 20.0);
+    c.crossover = BiquadFilter::design(BiquadFilter::LowPass, frequency, 0.707,
+                                       0.0, sampleRate);
+    c.attack = exp(-1.0 / (sampleRate * 0.5 / 1000.0));
+    c.release = exp(-1.0 / (sampleRate * 50.0 / 1000.0));
+    return c;
+  }
+
+  void setCoefficients(const Coefficients &c) {
+    threshold = c.threshold;
+    maxAttenuation = c.maxAttenuation;
+    grExponent = c.grExponent;
+    attack = c.attack;
+    release = c.release;
+    crossover.setCoefficients(c.crossover);
+  }
+
+  void setParameters(double thresholdDb, double frequency, double rangeDb,
+                     double ratio, double sampleRate) {
+    setCoefficients(design(thresholdDb, frequency, rangeDb, ratio, sampleRate));
+  }
+
+  void setControlRate(int interval, ControlRateGain::Interpolation mode) {
+    for (auto &gc : gainControl) {
+      gc.setInterval(interval);
+      gc.setInterpolation(mode);
+    }
+  }
+
+  void processBlock(float *x, int numFrames) {
+    const int interval = gainControl[0].getInterval();
+    alignas(64) float lowBand[32 * Lanes];
+    for (int start = 0; start < numFrames; start += interval) {
+      const int n = std::min(interval, numFrames - start);
+      float *seg = x + start * Lanes;
+
+      // seg keeps the high band until the gain is known
+      std::copy_n(seg, n * Lanes, lowBand);
+      crossover.processBlock(lowBand, n);
+      for (int i = 0; i < n * Lanes; i += Lanes) {
+        for (int c = 0; c < Lanes; ++c) {
+          seg[i + c] -= lowBand[i + c];
+          const double absHigh = std::fabs(seg[i + c]);
+          const double coeff = absHigh > envelope[c] ? attack : release;
+          envelope[c] = coeff * (envelope[c] - absHigh) + absHigh;
+        }
+      }
+
+      for (int c = 0; c < Lanes; ++c) {
+        float gain = 1.0f;
+        if (envelope[c] > threshold)
+          gain = FastMath::pow((float)(envelope[c] / threshold), grExponent);
+        gainControl[c].beginSegment(std::max(gain, (float)maxAttenuation));
+      }
+
+      const float invN = 1.0f / (float)n;
+      for (int i = 0; i < n; ++i) {
+        const float t = (float)(i + 1) * invN;
+        for (int c = 0; c < Lanes; ++c) {
+          const int k = i * Lanes + c;
+          seg[k] = lowBand[k] + seg[k] * gainControl[c].at(t);
+        }
+      }
+    }
+  }
+
+private:
+  BiquadLanes<Lanes> crossover;
+  ControlRateGain gainControl[Lanes];
+  double threshold = 0.5, maxAttenuation = 0.5;
+  float grExponent = -0.8f;
+  double attack = 0.0, release = 0.0;
+  alignas(64) double envelope[Lanes] = {};
+};
+
+// --- FET Compressor (Lanes) ---
+template <int Lanes> class FETCompressorLanes : LaneWidth<Lanes> {
+public:
+  FETCompressorLanes() {
+    for (int c = 0; c < Lanes; ++c)
+      effectiveThreshold[c] = kThreshold;
+  }
+
+  struct Coefficients {
+    double inputGain = 1.0;
+    float grExponent = -0.75f;
+    double attackCoeff = 0.0, releaseCoeff = 0.0;
+    double makeupGain = 1.0;
+    bool linked = false;
+  };
+
+  // linked: one detector on the louder lane, one gain for both
+  static Coefficients design(double inputDb, double ratio, double attackMs,
+                             double releaseMs, double makeupDb,
+                             bool autoMakeup, bool linked,
+                             double sampleRate) {
+    Coefficients c;
+    c.linked = linked;
+    c.inputGain = pow(10.0, inputDb / 20.0);
+    c.grExponent = (float)(1.0 / ratio - 1.0);
+    c.attackCoeff = exp(-1.0 / (sampleRate * attackMs / 1000.0));
+    c.releaseCoeff = exp(-1.0 / (sampleRate * releaseMs / 1000.0));
+    if (autoMakeup) {
+      double tDb = 20.0 * log10(kThreshold);
+      double attenuationDb = (0.0 - tDb) * (1.0 - 1.0 / ratio);
+      c.makeupGain = pow(10.0, attenuationDb / 20.0);
+    } else {
+      c.makeupGain = pow(10.0, makeupDb / 20.0);
+    }
+    return c;
+  }
+
+  void setCoefficients(const Coefficients &c) {
+    inputGain = c.inputGain;
+    grExponent = c.grExponent;
+    attackCoeff = c.attackCoeff;
+    releaseCoeff = c.releaseCoeff;
+    makeupGain = c.makeupGain;
+    // Unlinking: every lane carries on from the shared state
+    if (linked && !c.linked) {
+      for (int lane = 1; lane < Lanes; ++lane) {
+        envelope[lane] = envelope[0];
+        gainControl[lane] = gainControl[0];
+      }
+    }
+    linked = c.linked;
+  }
+
+  void setParameters(double inputDb, double ratio, double attackMs,
+                     double releaseMs, double makeupDb, double sampleRate) {
+    setCoefficients(design(inputDb, ratio, attackMs, releaseMs, makeupDb,
+                           autoMakeup, linked, sampleRate));
+  }
+
+  void setAutoMakeup(bool enabled) { autoMakeup = enabled; }
+
+  void setThresholdOffset(int lane, double db) {
+    effectiveThreshold[lane] = kThreshold * pow(10.0, db / 20.0);
+  }
+
+  void setControlRate(int interval, ControlRateGain::Interpolation mode) {
+    for (auto &gc : gainControl) {
+      gc.setInterval(interval);
+      gc.setInterpolation(mode);
+    }
+  }
+
+  void processBlock(float *x, int numFrames) {
+    if (linked) {
+      processLinked(x, numFrames);
+      return;
+    }
+    const float drive = (float)inputGain;
+    const float makeup = (float)makeupGain;
+    const int interval = gainControl[0].getInterval();
+    for (int start = 0; start < numFrames; start += interval) {
+      const int n = std::min(interval, numFrames - start);
+      float *seg = x + start * Lanes;
+
+      for (int i = 0; i < n; ++i) {
+        float *frame = seg + i * Lanes;
+        for (int c = 0; c < Lanes; ++c) {
+          frame[c] *= drive;
+          const double absInput = std::fabs(frame[c]);
+          const double coeff =
+              absInput > envelope[c] ? attackCoeff : releaseCoeff;
+          envelope[c] = coeff * (envelope[c] - absInput) + absInput;
+        }
+      }
+
+      for (int c = 0; c < Lanes; ++c) {
+        float gain = 1.0f;
+        if (envelope[c] > effectiveThreshold[c])
+          gain = FastMath::pow((float)(envelope[c] / effectiveThreshold[c]),
+                               grExponent);
+        gainControl[c].beginSegment(gain);
+      }
+
+      const float invN = 1.0f / (float)n;
+      for (int i = 0; i < n; ++i) {
+        const float t = (float)(i + 1) * invN;
+        float *frame = seg + i * Lanes;
+        for (int c = 0; c < Lanes; ++c)
+          frame[c] *= gainControl[c].at(t) * makeup;
+      }
+    }
+  }
+
+private:
+  static constexpr double kThreshold = 0.1; // -20dB
+
+  // Lane 0's envelope and gain control serve every lane, against the
+  // lowest lane threshold
+  void processLinked(float *x, int numFrames) {
+    const float drive = (float)inputGain;
+    const float makeup = (float)makeupGain;
+    double threshold = effectiveThreshold[0];
+    for (int c = 1; c < Lanes; ++c)
+      threshold = std::min(threshold, effectiveThreshold[c]);
+    const int interval = gainControl[0].getInterval();
+    for (int start = 0; start < numFrames; start += interval) {
+      const int n = std::min(interval, numFrames - start);
+      float *seg = x + start * Lanes;
+
+      for (int i = 0; i < n; ++i) {
+        float *frame = seg + i * Lanes;
+        float peak = 0.0f;
+        for (int c = 0; c < Lanes; ++c) {
+          frame[c] *= drive;
+          peak = std::max(peak, std::fabs(frame[c]));
+        }
+        const double coeff = peak > envelope[0] ? attackCoeff : releaseCoeff;
+        envelope[0] = coeff * (envelope[0] - peak) + peak;
+      }
+
+      float gain = 1.0f;
+      if (envelope[0] > threshold)
+        gain = FastMath::pow((float)(envelope[0] / threshold), grExponent);
+      gainControl[0].beginSegment(gain);
+
+      const float invN = 1.0f / (float)n;
+      for (int i = 0; i < n; ++i) {
+        const float g = gainControl[0].at((float)(i + 1) * invN) * makeup;
+        float *frame = seg + i * Lanes;
+        for (int c = 0; c < Lanes; ++c)
+          frame[c] *= g;
+      }
+    }
+  }
+
+  ControlRateGain gainControl[Lanes];
+  double inputGain = 1.0;
+  float grExponent = -0.75f;
+  double attackCoeff = 0.0, releaseCoeff = 0.0;
+  double makeupGain = 1.0;
+  bool autoMakeup = false;
+  bool linked = false;
+  alignas(64) double effectiveThreshold[Lanes];
+  alignas(64) double envelope[Lanes] = {};
+};
+
+// --- Saturator (Lanes) ---
+template <int Lanes> class SaturatorLanes : LaneWidth<Lanes> {
+public:
+  SaturatorLanes() {
+    for (int c = 0; c < Lanes; ++c)
+      driveScale[c] = 1.0f;
+  }
+
+  struct Coefficients {
+    float drive = 1.0f;
+    int type = 0;
+    BiquadFilter::Coefficients preTone, postTone;
+  };
+
+  static Coefficients design(double drive, double type, double sampleRate) {
+    Coefficients c;
+    c.drive = (float)(1.0 + (drive / 10.0));
+    c.type = (int)type;
+    c.preTone = BiquadFilter::design(BiquadFilter::HighShelf, 4000.0, 0.707,
+                                     -6.0, sampleRate);
+    c.postTone = BiquadFilter::design(BiquadFilter::HighShelf, 4000.0, 0.707,
+                                      6.0, sampleRate);
+    return c;
+  }
+
+  void setCoefficients(const Coefficients &c) {
+    drive = c.drive;
+    type = c.type;
+    mPreTone.setCoefficients(c.preTone);
+    mPostTone.setCoefficients(c.postTone);
+  }
+
+  void setParameters(double drive, double type, double sampleRate) {
+    setCoefficients(design(drive, type, sampleRate));
+  }
+
+  void setDriveScale(int lane, double scale) { driveScale[lane] = (float)scale; }
+
+  void processBlock(float *x, int numFrames) {
+    mPreTone.processBlock(x, numFrames);
+
+    if (type == 0) { // Soft Clip (Tape-ish)
+      for (int i = 0; i < numFrames; ++i) {
+        float *frame = x + i * Lanes;
+        for (int c = 0; c < Lanes; ++c) {
+          const float v = frame[c] * drive * driveScale[c];
+          const float soft = v - (v * v * v) / 3.0f;
+          frame[c] = v > 1.0f ? 1.0f : (v < -1.0f ? -1.0f : soft);
+        }
+      }
+    } else { // Hard Clip (Tube-ish / Fuzz)
+      for (int i = 0; i < numFrames; ++i) {
+        float *frame = x + i * Lanes;
+        for (int c = 0; c < Lanes; ++c)
+          frame[c] = FastMath::tanh(frame[c] * drive * driveScale[c]);
+      }
+    }
+
+    mPostTone.processBlock(x, numFrames);
+  }
+
+private:
+  float drive = 1.0f;
+  int type = 0;
+  alignas(64) float driveScale[Lanes];
+  BiquadLanes<Lanes> mPreTone;
+  BiquadLanes<Lanes> mPostTone;
+};
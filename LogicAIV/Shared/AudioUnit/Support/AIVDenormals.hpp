@@ -0,0 +1,70 @@
+//
+//  AIVDenormals.hpp
+//  AIVExtension
+//
+//  Created by AIV on 02/02/2026.
+//
+
+#pragma once
+
+#import <cmath>
+#import <cstdint>
+
+#if defined(__SSE__) || defined(__x86_64__) || defined(_M_X64)
+#import <xmmintrin.h>
+#define AIV_DENORMALS_SSE 1
+#elif defined(__aarch64__)
+#define AIV_DENORMALS_ARM64 1
+#endif
+
+// --- Denormal Protection ---
+// A feedback loop fed silence decays toward zero through the subnormal
+// range, where x86 arithmetic runs 10-100x slower, exactly when a track has
+// gone quiet. Two layers keep that off the render thread:
+//   - ScopedNoDenormals sets flush-to-zero (and denormals-are-zero on x86)
+//     for the lifetime of a render call and restores the caller's mode
+//   - flushDenormal() zeroes a recursive state once it is far below audible
+//     level, so the loops stay fast on targets or threads without FTZ
+class ScopedNoDenormals {
+public:
+  ScopedNoDenormals() {
+#if AIV_DENORMALS_SSE
+    // FTZ (bit 15) | DAZ (bit 6)
+    mSaved = _mm_getcsr();
+    _mm_setcsr(mSaved | 0x8040);
+#elif AIV_DENORMALS_ARM64
+    // FPCR.FZ (bit 24); ARM flushes subnormal inputs with it as well
+    asm volatile("mrs %0, fpcr" : "=r"(mSaved));
+    asm volatile("msr fpcr, %0" : : "r"(mSaved | (uint64_t(1) << 24)));
+#endif
+  }
+
+  ~ScopedNoDenormals() {
+#if AIV_DENORMALS_SSE
+    _mm_setcsr(mSaved);
+#elif AIV_DENORMALS_ARM64
+    asm volatile("msr fpcr, %0" : : "r"(mSaved));
+#endif
+  }
+
+  ScopedNoDenormals(const ScopedNoDenormals &) = delete;
+  ScopedNoDenormals &operator=(const ScopedNoDenormals &) = delete;
+
+private:
+#if AIV_DENORMALS_SSE
+  unsigned int mSaved = 0;
+#elif AIV_DENORMALS_ARM64
+  uint64_t mSaved = 0;
+#endif
+};
+
+// About -300 dBFS: far below any output, far above the subnormal range of
+// float (1.2e-38) and double. A compare and select, so loops over it still
+// vectorize.
+inline float flushDenormal(float x) {
+  return std::fabs(x) < 1e-15f ? 0.0f : x;
+}
+
+inline double flushDenormal(double x) {
+  return std::fabs(x) < 1e-15 ? 0.0 : x;
+}
@@ -0,0 +1,296 @@
+//
+//  AIVFFT.hpp
+//  AIVExtension
+//
+//  Created by AIV on 02/02/2026.
+//
+
+#pragma once
+
+#import <cmath>
+#import <memory>
+#import <mutex>
+#import <vector>
+
+// --- FFT Plan ---
+// Read-only tables for one power-of-two real transform size: the bit
+// reversal of the half-size complex FFT, its twiddles laid out stage by
+// stage, and the twiddles of the real split. Plans are built once per size
+// and shared by every RealFFT in the process (see get()).
+class FFTPlan {
+public:
+  static constexpr int kMinLog2 = 2;
+  static constexpr int kMaxLog2 = 16; // 65536 real samples
+
+  // Shared plan for size real samples (a power of two up to 65536).
+  // Builds it on first use, so not real-time safe; thread-safe.
+  static std::shared_ptr<const FFTPlan> get(int size) {
+    int log2 = kMinLog2;
+    while ((1 << log2) < size && log2 < kMaxLog2)
+      ++log2;
+    static std::mutex mutex;
+    static std::shared_ptr<const FFTPlan> plans[kMaxLog2 + 1];
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!plans[log2])
+      plans[log2].reset(new FFTPlan(1 << log2));
+    return plans[log2];
+  }
+
+  explicit FFTPlan(int size) : size(size), half(size / 2) {
+    const double kTwoPi = 6.28318530717958647692;
+    int bits = 0;
+    while ((1 << bits) < half)
+      ++bits;
+    bitReverse.resize(half);
+    for (int i = 0; i < half; ++i) {
+      int reversed = 0;
+      for (int b = 0; b < bits; ++b)
+        reversed |= ((i >> b) & 1) << (bits - 1 - b);
+      bitReverse[i] = reversed;
+    }
+
+    // An odd number of bits leaves one radix-2 stage in front of the
+    // radix-4 ones. Each radix-4 stage of quarter span s needs W^j, W^2j and
+    // W^3j for j < s, with W = e^(-2 pi i / 4s), stored contiguously so the
+    // butterfly loop over j reads them in order.
+    firstSpan = (bits & 1) ? 2 : 1;
+    for (int s = firstSpan; 4 * s <= half; s *= 4) {
+      for (int k = 1; k <= 3; ++k) {
+        for (int j = 0; j < s; ++j) {
+          const double angle = -kTwoPi * k * j / (4.0 * s);
+          twiddleRe.push_back((float)std::cos(angle));
+          twiddleIm.push_back((float)std::sin(angle));
+        }
+      }
+    }
+
+    // Split twiddles of the full size: e^(-2 pi i k / N)
+    splitCos.resize(half + 1);
+    splitSin.resize(half + 1);
+    for (int k = 0; k <= half; ++k) {
+      splitCos[k] = (float)std::cos(kTwoPi * k / size);
+      splitSin[k] = (float)-std::sin(kTwoPi * k / size);
+    }
+  }
+
+  const int size;
+  const int half;
+  int firstSpan = 1; // 2 when a radix-2 stage runs first
+  std::vector<int> bitReverse;
+  std::vector<float> twiddleRe, twiddleIm;
+  std::vector<float> splitCos, splitSin;
+};
+
+// --- Real FFT ---
+// Power-of-two real <-> complex transform. A real signal of size N is packed
+// into a complex one of size N / 2 (even samples real, odd samples
+// imaginary), transformed with an iterative radix-4 FFT and split into the
+// N / 2 + 1 bins of the real spectrum. Spectra are kept as separate real
+// and imaginary arrays so the butterflies and per-bin loops vectorize.
+// The tables come from the shared FFTPlan; each instance only owns its work
+// buffers. Everything is allocated in the constructor; the transforms do not
+// allocate. One instance per thread.
+class RealFFT {
+public:
+  explicit RealFFT(int size)
+      : mPlan(FFTPlan::get(size)), mSize(mPlan->size), mHalf(mPlan->half) {
+    mRe.resize(mHalf);
+    mIm.resize(mHalf);
+  }
+
+  int size() const { return mSize; }
+  int numBins() const { return mHalf + 1; }
+
+  // size real samples -> numBins() bins, unnormalized
+  void forward(const float *input, float *re, float *im) {
+    load(input);
+    transform(false);
+    split(re, im, re + mHalf, im + mHalf);
+  }
+
+  // numBins() bins -> size real samples; inverse(forward(x)) == x
+  void inverse(const float *re, const float *im, float *output) {
+    unsplit(re, im, re[mHalf], im[mHalf]);
+    transform(true);
+    store(output);
+  }
+
+  // In place on size floats. The spectrum is packed: data[0] holds bin 0,
+  // data[1] the Nyquist bin (both real), then re, im of bins 1 .. N/2 - 1.
+  void forward(float *data) {
+    load(data);
+    transform(false);
+    float nyquistIm = 0.0f;
+    split(data, data + 1, data + 1, &nyquistIm, 2);
+  }
+
+  void inverse(float *data) {
+    unsplit(data, data + 1, data[1], 0.0f, 2);
+    transform(true);
+    store(data);
+  }
+
+private:
+  void load(const float *input) {
+    const int *bitReverse = mPlan->bitReverse.data();
+    for (int n = 0; n < mHalf; ++n) {
+      const int r = bitReverse[n];
+      mRe[r] = input[2 * n];
+      mIm[r] = input[2 * n + 1];
+    }
+  }
+
+  void store(float *output) {
+    const float scale = 1.0f / mHalf;
+    for (int n = 0; n < mHalf; ++n) {
+      output[2 * n] = mRe[n] * scale;
+      output[2 * n + 1] = mIm[n] * scale;
+    }
+  }
+
+  // Split: X[k] = E[k] + W^k O[k] with E, O the spectra of the even and
+  // odd samples, recovered from Z[k] and conj(Z[N/2 - k]). Bins 1 .. N/2 - 1
+  // go to re/im with the given stride (1 split, 2 packed), then bin 0 and
+  // the Nyquist bin, so a packed layout can overwrite bin 1's slot last.
+  void split(float *re, float *im, float *nyquistRe, float *nyquistIm,
+             int stride = 1) {
+    const float *splitCos = mPlan->splitCos.data();
+    const float *splitSin = mPlan->splitSin.data();
+    for (int k = 1; k < mHalf; ++k) {
+      const float zr = mRe[k], zi = mIm[k];
+      const float cr = mRe[mHalf - k], ci = -mIm[mHalf - k];
+      const float er = 0.5f * (zr + cr), ei = 0.5f * (zi + ci);
+      // O = (Z - conj(Z')) / 2i
+      const float or_ = 0.5f * (zi - ci), oi = -0.5f * (zr - cr);
+      const float wr = splitCos[k], wi = splitSin[k];
+      re[k * stride] = er + wr * or_ - wi * oi;
+      im[k * stride] = ei + wr * oi + wi * or_;
+    }
+    const float dc = mRe[0] + mIm[0], nyquist = mRe[0] - mIm[0];
+    re[0] = dc;
+    if (stride == 1)
+      im[0] = 0.0f;
+    *nyquistRe = nyquist;
+    *nyquistIm = 0.0f;
+  }
+
+  // Undo the split: E = (X[k] + conj(X[N/2 - k])) / 2,
+  // O = (X[k] - conj(X[N/2 - k])) / (2 W^k), Z = E + iO, written in
+  // bit-reversed order for the transform. Bin 0's imaginary part is taken
+  // as 0 and the Nyquist bin comes separately, so the packed layout works.
+  void unsplit(const float *re, const float *im, float nyquistRe,
+               float nyquistIm, int stride = 1) {
+    const int *bitReverse = mPlan->bitReverse.data();
+    const float *splitCos = mPlan->splitCos.data();
+    const float *splitSin = mPlan->splitSin.data();
+    for (int k = 0; k < mHalf; ++k) {
+      const float xr = re[k * stride], xi = k ? im[k * stride] : 0.0f;
+      const float cr = k ? re[(mHalf - k) * stride] : nyquistRe;
+      const float ci = k ? -im[(mHalf - k) * stride] : -nyquistIm;
+      const float er = 0.5f * (xr + cr), ei = 0.5f * (xi + ci);
+      const float dr = 0.5f * (xr - cr), di = 0.5f * (xi - ci);
+      // Divide by W^k: multiply by its conjugate
+      const float wr = splitCos[k], wi = -splitSin[k];
+      const float or_ = dr * wr - di * wi, oi = dr * wi + di * wr;
+      const int r = bitReverse[k];
+      mRe[r] = er - oi;
+      mIm[r] = ei + or_;
+    }
+  }
+
+  // In-place iterative FFT over mRe / mIm, already in bit-reversed order:
+  // a radix-2 stage when log2(N / 2) is odd, then radix-4 stages. inverse
+  // conjugates the twiddles.
+  void transform(bool inverse) {
+    float *re = mRe.data(), *im = mIm.data();
+    const float sign = inverse ? -1.0f : 1.0f;
+
+    if (mPlan->firstSpan == 2) {
+      for (int a = 0; a < mHalf; a += 2) {
+        const float br = re[a + 1], bi = im[a + 1];
+        re[a + 1] = re[a] - br;
+        im[a + 1] = im[a] - bi;
+        re[a] += br;
+        im[a] += bi;
+      }
+    }
+
+    const float *twiddleRe = mPlan->twiddleRe.data();
+    const float *twiddleIm = mPlan->twiddleIm.data();
+    int s = mPlan->firstSpan;
+    if (s == 1 && mHalf >= 4) {
+      // First radix-4 stage: every twiddle is 1
+      for (int a = 0; a < mHalf; a += 4) {
+        const float sr = re[a] + re[a + 1], si = im[a] + im[a + 1];
+        const float tr = re[a] - re[a + 1], ti = im[a] - im[a + 1];
+        const float ur = re[a + 2] + re[a + 3], ui = im[a + 2] + im[a + 3];
+        const float vr = sign * (im[a + 2] - im[a + 3]);
+        const float vi = -sign * (re[a + 2] - re[a + 3]);
+        re[a] = sr + ur;
+        im[a] = si + ui;
+        re[a + 1] = tr + vr;
+        im[a + 1] = ti + vi;
+        re[a + 2] = sr - ur;
+        im[a + 2] = si - ui;
+        re[a + 3] = tr - vr;
+        im[a + 3] = ti - vi;
+      }
+      twiddleRe += 3;
+      twiddleIm += 3;
+      s = 4;
+    }
+    for (; 4 * s <= mHalf; s *= 4) {
+      for (int start = 0; start < mHalf; start += 4 * s)
+        radix4(re + start, im + start, re + start + s, im + start + s,
+               re + start + 2 * s, im + start + 2 * s, re + start + 3 * s,
+               im + start + 3 * s, twiddleRe, twiddleIm, s, sign);
+      twiddleRe += 3 * s;
+      twiddleIm += 3 * s;
+    }
+  }
+
+  // One group of radix-4 butterflies over quarters of span s. The quarters
+  // never overlap; saying so lets the loop over j vectorize without
+  // run-time alias checks.
+  static void radix4(float *__restrict r0, float *__restrict i0,
+                     float *__restrict r1, float *__restrict i1,
+                     float *__restrict r2, float *__restrict i2,
+                     float *__restrict r3, float *__restrict i3,
+                     const float *__restrict twiddleRe,
+                     const float *__restrict twiddleIm, int s, float sign) {
+    const float *w1r = twiddleRe, *w1i = twiddleIm;
+    const float *w2r = w1r + s, *w2i = w1i + s;
+    const float *w3r = w2r + s, *w3i = w2i + s;
+    for (int j = 0; j < s; ++j) {
+      // Bit reversal leaves the residues mod 4 in the order 0, 2, 1, 3
+      const float ar = r0[j], ai = i0[j];
+      const float w1x = w1r[j], w1y = sign * w1i[j];
+      const float w2x = w2r[j], w2y = sign * w2i[j];
+      const float w3x = w3r[j], w3y = sign * w3i[j];
+      const float br = r1[j] * w2x - i1[j] * w2y;
+      const float bi = r1[j] * w2y + i1[j] * w2x;
+      const float cr = r2[j] * w1x - i2[j] * w1y;
+      const float ci = r2[j] * w1y + i2[j] * w1x;
+      const float dr = r3[j] * w3x - i3[j] * w3y;
+      const float di = r3[j] * w3y + i3[j] * w3x;
+      const float sr = ar + br, si = ai + bi;
+      const float tr = ar - br, ti = ai - bi;
+      const float ur = cr + dr, ui = ci + di;
+      // -i (c - d) forward, +i inverse
+      const float vr = sign * (ci - di), vi = -sign * (cr - dr);
+      r0[j] = sr + ur;
+      i0[j] = si + ui;
+      r1[j] = tr + vr;
+      i1[j] = ti + vi;
+      r2[j] = sr - ur;
+      i2[j] = si - ui;
+      r3[j] = tr - vr;
+      i3[j] = ti - vi;
+    }
+  }
+
+  std::shared_ptr<const FFTPlan> mPlan;
+  int mSize;
+  int mHalf;
+  std::vector<float> mRe, mIm;
+};
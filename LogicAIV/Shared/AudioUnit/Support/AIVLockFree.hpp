@@ -0,0 +1,172 @@
+//
+//  AIVLockFree.hpp
+//  AIVExtension
+//
+//  Created by AIV on 02/02/2026.
+//
+
+#pragma once
+
+#import <algorithm>
+#import <atomic>
+#import <cstddef>
+#import <vector>
+
+#import <pthread.h>
+
+#if defined(__APPLE__)
+#import <mach/mach.h>
+#else
+#import <semaphore.h>
+#endif
+
+// --- Coefficient Exchange ---
+// Hands complete coefficient sets from the threads that design them to the
+// render thread without locks or allocation. Three slots: the writer fills
+// the back slot and publishes it by swapping it with the middle one; the
+// reader swaps the middle slot with its front slot when a fresh set is
+// flagged. Neither side ever waits, and a set is never written while it is
+// being read. One writer at a time, one reader.
+template <typename T> class TripleBuffer {
+public:
+  T &back() { return mSlots[mBack]; }
+
+  void publish() { mBack = mMiddle.exchange(mBack | kFresh) & kIndexMask; }
+
+  // Newest published set, or nullptr if nothing new since the last call
+  const T *acquire() {
+    if (!(mMiddle.load(std::memory_order_relaxed) & kFresh))
+      return nullptr;
+    mFront = mMiddle.exchange(mFront) & kIndexMask;
+    return &mSlots[mFront];
+  }
+
+private:
+  static constexpr int kIndexMask = 3;
+  static constexpr int kFresh = 4;
+
+  T mSlots[3];
+  std::atomic<int> mMiddle{1};
+  int mBack = 0;
+  int mFront = 2;
+};
+
+// --- SPSC Ring ---
+// Wait-free FIFO from one producer thread to one consumer thread over a
+// power-of-two buffer. Reads and writes are all-or-nothing, so a block never
+// arrives torn, and a full ring rejects a write instead of waiting. The
+// indices run freely and are masked on access; each is written by one side
+// only, a cache line apart.
+template <typename T> class SPSCRing {
+public:
+  // Not thread-safe: call while neither side is running
+  void allocate(size_t minCapacity) {
+    size_t capacity = 1;
+    while (capacity < minCapacity)
+      capacity <<= 1;
+    mBuffer.assign(capacity, T());
+    mMask = capacity - 1;
+    mWrite.store(0, std::memory_order_relaxed);
+    mRead.store(0, std::memory_order_relaxed);
+  }
+
+  // Producer side
+  size_t writeAvailable() const {
+    return mBuffer.size() - (mWrite.load(std::memory_order_relaxed) -
+                             mRead.load(std::memory_order_acquire));
+  }
+
+  bool write(const T *data, size_t count) {
+    if (count > writeAvailable())
+      return false;
+    const size_t write = mWrite.load(std::memory_order_relaxed);
+    const size_t start = write & mMask;
+    const size_t first = std::min(count, mBuffer.size() - start);
+    std::copy(data, data + first, mBuffer.data() + start);
+    std::copy(data + first, data + count, mBuffer.data());
+    mWrite.store(write + count, std::memory_order_release);
+    return true;
+  }
+
+  // Consumer side
+  size_t readAvailable() const {
+    return mWrite.load(std::memory_order_acquire) -
+           mRead.load(std::memory_order_relaxed);
+  }
+
+  bool read(T *data, size_t count) {
+    if (count > readAvailable())
+      return false;
+    const size_t read = mRead.load(std::memory_order_relaxed);
+    const size_t start = read & mMask;
+    const size_t first = std::min(count, mBuffer.size() - start);
+    std::copy(mBuffer.data() + start, mBuffer.data() + start + first, data);
+    std::copy(mBuffer.data(), mBuffer.data() + (count - first), data + first);
+    mRead.store(read + count, std::memory_order_release);
+    return true;
+  }
+
+private:
+  std::vector<T> mBuffer;
+  size_t mMask = 0;
+  // Padded rather than alignas(64): C++14 new does not honour extended
+  // alignment
+  std::atomic<size_t> mWrite{0};
+  char mPad[64 - sizeof(std::atomic<size_t>)];
+  std::atomic<size_t> mRead{0};
+};
+
+// --- Wake Semaphore ---
+// Counting semaphore for waking a worker thread from the render thread
+// (a Mach semaphore on Apple). signal() never blocks and takes no lock, so
+// the render thread can post work without risking a priority inversion;
+// the worker sleeps in wait() instead of polling.
+class WakeSemaphore {
+public:
+#if defined(__APPLE__)
+  WakeSemaphore() {
+    semaphore_create(mach_task_self(), &mSemaphore, SYNC_POLICY_FIFO, 0);
+  }
+  ~WakeSemaphore() { semaphore_destroy(mach_task_self(), mSemaphore); }
+
+  void signal() { semaphore_signal(mSemaphore); }
+  void wait() {
+    while (semaphore_wait(mSemaphore) == KERN_ABORTED) {
+    }
+  }
+#else
+  WakeSemaphore() { sem_init(&mSemaphore, 0, 0); }
+  ~WakeSemaphore() { sem_destroy(&mSemaphore); }
+
+  void signal() { sem_post(&mSemaphore); }
+  void wait() {
+    while (sem_wait(&mSemaphore) != 0) {
+    }
+  }
+#endif
+
+  WakeSemaphore(const WakeSemaphore &) = delete;
+  WakeSemaphore &operator=(const WakeSemaphore &) = delete;
+
+private:
+#if defined(__APPLE__)
+  semaphore_t mSemaphore;
+#else
+  sem_t mSemaphore;
+#endif
+};
+
+// --- Worker Priority ---
+// Raises the calling worker thread above ordinary threads, for workers
+// whose results the render thread needs by a deadline. User-interactive
+// QoS on Apple; elsewhere the lowest real-time priority, which needs
+// privileges and is skipped silently without them.
+inline void raiseWorkerPriority() {
+#if defined(__APPLE__)
+  pthread_set_qos_class_self_np(QOS_CLASS_USER_INTERACTIVE, 0);
+#else
+  sched_param param = {};
+  param.sched_priority = sched_get_priority_min(SCHED_FIFO);
+  pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+#endif
+}
@@ -0,0 +1,229 @@
+//
+//  AIVPitchDetector.hpp
+//  AIVExtension
+//
+//  Created by AIV on 02/02/2026.
+//
+
+#pragma once
+
+#import <algorithm>
+#import <cmath>
+#import <memory>
+#import <vector>
+
+#import "AIVDSPClasses.hpp"
+#import "AIVFFT.hpp"
+
+// --- Pitch Detector (McLeod Pitch Method) ---
+// Streaming f0 estimate for monophonic sources. The input is low-passed and
+// decimated to about 11 kHz, which is plenty for vocal fundamentals, and
+// every kHop analysis samples the last kWindow are analysed:
+//   1. autocorrelation r(tau) through one real FFT pair (|X|^2, zero-padded
+//      to 2 * kWindow so it is linear, not circular)
+//   2. normalized square difference n(tau) = 2 r(tau) / m(tau), with m from
+//      a running sum of squares
+//   3. the first key maximum within kCutoff of the highest one, refined by
+//      parabolic interpolation
+// Each hop costs O(kWindow log kWindow). The height of the chosen maximum
+// (the NSDF "clarity", 0..1) is reported as confidence; unvoiced or silent
+// hops report pitch 0. All buffers are allocated in initialize().
+class PitchDetector {
+public:
+  static constexpr int kWindow = 512; // analysis samples, power of two
+  static constexpr int kHop = 128;
+  static constexpr double kAnalysisRate = 11025.0; // approximate
+  static constexpr double kMinPitch = 50.0;
+  static constexpr double kMaxPitch = 1500.0;
+
+  // Not real-time safe
+  void initialize(double sampleRate) {
+    decimation = std::max(1, (int)std::lround(sampleRate / kAnalysisRate));
+    analysisRate = sampleRate / decimation;
+    // 4th-order Butterworth at half the decimated Nyquist. Besides stopping
+    // aliases, it keeps the NSDF lobes wide enough for parabolic
+    // interpolation to find the true peak height at short lags.
+    const double cutoff = 0.25 * analysisRate;
+    antiAlias[0].calculateCoefficients(BiquadFilter::LowPass, cutoff, 0.5412,
+                                       0.0, sampleRate);
+    antiAlias[1].calculateCoefficients(BiquadFilter::LowPass, cutoff, 1.3066,
+                                       0.0, sampleRate);
+
+    minLag = std::max(2, (int)(analysisRate / kMaxPitch));
+    maxLag = std::min(kWindow / 2, (int)(analysisRate / kMinPitch) + 1);
+
+    fft.reset(new RealFFT(2 * kWindow));
+    history.assign(kWindow, 0.0f);
+    frame.assign(2 * kWindow, 0.0f);
+    spectrumRe.assign(fft->numBins(), 0.0f);
+    spectrumIm.assign(fft->numBins(), 0.0f);
+    nsdf.assign(kWindow / 2 + 1, 0.0f);
+    reset();
+  }
+
+  void reset() {
+    for (auto &f : antiAlias)
+      f.reset();
+    std::fill(history.begin(), history.end(), 0.0f);
+    writePos = 0;
+    phase = 0;
+    pending = 0;
+    pitch = 0.0f;
+    confidence = 0.0f;
+  }
+
+  // Interleaved frames of numChannels, analysed as their mono sum.
+  // Returns the number of new estimates (hops completed) in this block.
+  int process(const float *frames, int numChannels, int numFrames) {
+    const float scale = 1.0f / numChannels;
+    int estimates = 0;
+    for (int i = 0; i < numFrames; ++i) {
+      float mono = 0.0f;
+      for (int c = 0; c < numChannels; ++c)
+        mono += frames[i * numChannels + c];
+      const float filtered =
+          antiAlias[1].process(antiAlias[0].process(mono * scale));
+      if (++phase < decimation)
+        continue;
+      phase = 0;
+
+      history[writePos] = filtered;
+      writePos = (writePos + 1) & (kWindow - 1);
+      if (++pending == kHop) {
+        pending = 0;
+        analyze();
+        ++estimates;
+      }
+    }
+    return estimates;
+  }
+
+  // Hz of the latest hop, 0 if it was unvoiced
+  float getPitch() const { return pitch; }
+  // NSDF clarity of the latest hop, 0..1
+  float getConfidence() const { return confidence; }
+  // Input samples between two estimates
+  int getHopSize() const { return kHop * decimation; }
+
+private:
+  // Below this the key maxima are noise, not periodicity
+  static constexpr float kMinClarity = 0.5f;
+  // A key maximum this close to the highest one wins if it comes first,
+  // which keeps the estimate off the octave below
+  static constexpr float kCutoff = 0.93f;
+
+  void analyze() {
+    // Oldest sample first, zero-padded to the transform size
+    const int tail = kWindow - writePos;
+    std::copy(history.begin() + writePos, history.end(), frame.begin());
+    std::copy(history.begin(), history.begin() + writePos,
+              frame.begin() + tail);
+    std::fill(frame.begin() + kWindow, frame.end(), 0.0f);
+
+    // m(tau) = sum of x[j]^2 + x[j + tau]^2 over the overlap
+    double m = 0.0;
+    for (int j = 0; j < kWindow; ++j)
+      m += (double)frame[j] * frame[j];
+    // Silent hop: about -80 dBFS RMS
+    if (m < kWindow * 1e-8) {
+      pitch = 0.0f;
+      confidence = 0.0f;
+      return;
+    }
+    m *= 2.0;
+
+    // r(tau) = IFFT(|X|^2)
+    fft->forward(frame.data(), spectrumRe.data(), spectrumIm.data());
+    for (int k = 0; k < fft->numBins(); ++k) {
+      spectrumRe[k] =
+          spectrumRe[k] * spectrumRe[k] + spectrumIm[k] * spectrumIm[k];
+      spectrumIm[k] = 0.0f;
+    }
+    // m(tau) steps over the signal, which frame holds until the inverse
+    const int lags = maxLag + 1;
+    for (int tau = 0; tau < lags; ++tau) {
+      nsdf[tau] = (float)m;
+      m -= (double)frame[tau] * frame[tau] +
+           (double)frame[kWindow - 1 - tau] * frame[kWindow - 1 - tau];
+    }
+    fft->inverse(spectrumRe.data(), spectrumIm.data(), frame.data());
+    for (int tau = 0; tau < lags; ++tau)
+      nsdf[tau] = nsdf[tau] > 0.0f ? 2.0f * frame[tau] / nsdf[tau] : 0.0f;
+
+    pickPeak();
+  }
+
+  void pickPeak() {
+    // Key maxima: the highest point of each positive lobe after the first
+    // negative-going zero crossing
+    int numKeys = 0;
+    float highest = 0.0f;
+    int tau = 1;
+    while (tau < maxLag && nsdf[tau] > 0.0f)
+      ++tau;
+    int best = -1;
+    for (; tau < maxLag; ++tau) {
+      if (nsdf[tau] > 0.0f) {
+        if (best < 0 || nsdf[tau] > nsdf[best])
+          best = tau;
+      } else if (best >= 0) {
+        addKey(best, numKeys, highest);
+        best = -1;
+      }
+    }
+    // A lobe cut off by maxLag still counts if its maximum is inside it
+    if (best >= 0 && nsdf[best] > nsdf[best + 1])
+      addKey(best, numKeys, highest);
+
+    if (numKeys == 0 || highest < kMinClarity) {
+      pitch = 0.0f;
+      confidence = highest;
+      return;
+    }
+
+    // Heights are compared after interpolation: at high pitches the period
+    // is only a few samples and the sampled maxima can sit well below the
+    // true ones, which would otherwise favour the octave below
+    int chosen = 0;
+    while (keyHeights[chosen] < kCutoff * highest)
+      ++chosen;
+    pitch = (float)(analysisRate / keyLags[chosen]);
+    confidence = std::min(1.0f, keyHeights[chosen]);
+  }
+
+  // Refines a key maximum with a parabola through it and its neighbours
+  void addKey(int tau, int &numKeys, float &highest) {
+    if (tau < minLag)
+      return;
+    const float a = nsdf[tau - 1], b = nsdf[tau], c = nsdf[tau + 1];
+    const float denom = a - 2.0f * b + c;
+    float offset = 0.0f, height = b;
+    if (denom < 0.0f) {
+      offset = 0.5f * (a - c) / denom;
+      height = b - 0.25f * (a - c) * offset;
+    }
+    keyLags[numKeys] = tau + offset;
+    keyHeights[numKeys] = height;
+    ++numKeys;
+    highest = std::max(highest, height);
+  }
+
+  BiquadFilter antiAlias[2];
+  int decimation = 4;
+  double analysisRate = 11025.0;
+  int minLag = 7, maxLag = kWindow / 2;
+
+  std::unique_ptr<RealFFT> fft;
+  std::vector<float> history; // ring of decimated samples
+  std::vector<float> frame;
+  std::vector<float> spectrumRe, spectrumIm;
+  std::vector<float> nsdf;
+  float keyLags[kWindow / 2];
+  float keyHeights[kWindow / 2];
+  int writePos = 0;
+  int phase = 0;
+  int pending = 0;
+
+  float pitch = 0.0f;
+  float confidence = 0.0f;
+};
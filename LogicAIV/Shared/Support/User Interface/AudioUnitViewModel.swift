@@ -26,6 +26,9 @@ public class AudioUnitViewModel: ObservableObject {
     // Pitch
     @Published var pitchAmount: Double = 50 { didSet { setParam(pitchAmountParam, pitchAmount) } }
     @Published var pitchSpeed: Double = 20 { didSet { setParam(pitchSpeedParam, pitchSpeed) } }
+    @Published var pitchKey: Double = 0 { didSet { setParam(pitchKeyParam, pitchKey) } }
+    @Published var pitchScale: Double = 1 { didSet { setParam(pitchScaleParam, pitchScale) } }
+    @Published var pitchNotes: Double = 4095 { didSet { setParam(pitchNotesParam, pitchNotes) } }
     
     // Deesser
     @Published var deesserThresh: Double = -20 { didSet { setParam(deesserThreshParam, deesserThresh) } }
@@ -65,10 +68,14 @@ public class AudioUnitViewModel: ObservableObject {
     // Limiter
     @Published var limiterCeiling: Double = -0.1 { didSet { setParam(limiterCeilingParam, limiterCeiling) } }
     @Published var limiterLookahead: Double = 2.0 { didSet { setParam(limiterLookaheadParam, limiterLookahead) } }
+    @Published var dynamicsLink: Bool = false { didSet { setParam(dynamicsLinkParam, dynamicsLink ? 1.0 : 0.0) } }
     
     // Saturation
     @Published var satDrive: Double = 0 { didSet { setParam(satDriveParam, satDrive) } }
     @Published var satType: Double = 0 { didSet { setParam(satTypeParam, satType) } }
+
+    // Quality
+    @Published var oversampling: Double = 2 { didSet { setParam(oversamplingParam, oversampling) } }
     
     // Delay
     @Published var delayTime: Double = 0.5 { didSet { setParam(delayTimeParam, delayTime) } }
@@ -98,6 +105,9 @@ public class AudioUnitViewModel: ObservableObject {
     private var autoLevelSpeedParam: AUParameter?
     private var pitchAmountParam: AUParameter?
     private var pitchSpeedParam: AUParameter?
+    private var pitchKeyParam: AUParameter?
+    private var pitchScaleParam: AUParameter?
+    private var pitchNotesParam: AUParameter?
     private var deesserThreshParam: AUParameter?
     private var deesserFreqParam: AUParameter?
     private var deesserRatioParam: AUParameter?
@@ -126,8 +136,10 @@ public class AudioUnitViewModel: ObservableObject {
     private var compAutoMakeupParam: AUParameter?
     private var limiterCeilingParam: AUParameter?
     private var limiterLookaheadParam: AUParameter?
+    private var dynamicsLinkParam: AUParameter?
     private var satDriveParam: AUParameter?
     private var satTypeParam: AUParameter?
+    private var oversamplingParam: AUParameter?
     private var delayTimeParam: AUParameter?
     private var delayFeedbackParam: AUParameter?
     private var delayMixParam: AUParameter?
@@ -182,6 +194,9 @@ public class AudioUnitViewModel: ObservableObject {
         
         pitchAmountParam = bind("pitchAmount"); pitchAmount = Double(pitchAmountParam?.value ?? 50)
         pitchSpeedParam = bind("pitchSpeed"); pitchSpeed = Double(pitchSpeedParam?.value ?? 20)
+        pitchKeyParam = bind("pitchKey"); pitchKey = Double(pitchKeyParam?.value ?? 0)
+        pitchScaleParam = bind("pitchScale"); pitchScale = Double(pitchScaleParam?.value ?? 1)
+        pitchNotesParam = bind("pitchNotes"); pitchNotes = Double(pitchNotesParam?.value ?? 4095)
         
         deesserThreshParam = bind("deesserThresh"); deesserThresh = Double(deesserThreshParam?.value ?? -20)
         deesserFreqParam = bind("deesserFreq"); deesserFreq = Double(deesserFreqParam?.value ?? 5000)
@@ -216,9 +231,11 @@ public class AudioUnitViewModel: ObservableObject {
         
         limiterCeilingParam = bind("limiterCeiling"); limiterCeiling = Double(limiterCeilingParam?.value ?? -0.1)
         limiterLookaheadParam = bind("limiterLookahead"); limiterLookahead = Double(limiterLookaheadParam?.value ?? 2.0)
+        dynamicsLinkParam = bind("dynamicsLink"); dynamicsLink = (Double(dynamicsLinkParam?.value ?? 0) > 0.5)
         
         satDriveParam = bind("satDrive"); satDrive = Double(satDriveParam?.value ?? 0)
         satTypeParam = bind("satType"); satType = Double(satTypeParam?.value ?? 0)
+        oversamplingParam = bind("oversampling"); oversampling = Double(oversamplingParam?.value ?? 2)
         
         delayTimeParam = bind("delayTime"); delayTime = Double(delayTimeParam?.value ?? 0.5)
         delayFeedbackParam = bind("delayFeedback"); delayFeedback = Double(delayFeedbackParam?.value ?? 0)
@@ -267,6 +284,9 @@ public class AudioUnitViewModel: ObservableObject {
         // Pitch
         else if address == pitchAmountParam?.address { pitchAmount = Double(value) }
         else if address == pitchSpeedParam?.address { pitchSpeed = Double(value) }
+        else if address == pitchKeyParam?.address { pitchKey = Double(value) }
+        else if address == pitchScaleParam?.address { pitchScale = Double(value) }
+        else if address == pitchNotesParam?.address { pitchNotes = Double(value) }
         // Deesser
         else if address == deesserThreshParam?.address { deesserThresh = Double(value) }
         else if address == deesserFreqParam?.address { deesserFreq = Double(value) }
@@ -298,9 +318,11 @@ public class AudioUnitViewModel: ObservableObject {
         else if address == compAutoMakeupParam?.address { compAutoMakeup = (value > 0.5) }
         else if address == limiterCeilingParam?.address { limiterCeiling = Double(value) }
         else if address == limiterLookaheadParam?.address { limiterLookahead = Double(value) }
+        else if address == dynamicsLinkParam?.address { dynamicsLink = (value > 0.5) }
         // Sat
         else if address == satDriveParam?.address { satDrive = Double(value) }
         else if address == satTypeParam?.address { satType = Double(value) }
+        else if address == oversamplingParam?.address { oversampling = Double(value) }
         // Delay
         else if address == delayTimeParam?.address { delayTime = Double(value) }
         else if address == delayFeedbackParam?.address { delayFeedback = Double(value) }
@@ -79,9 +79,15 @@ struct DynamicsModuleView: View {
                     }
                     VStack {
                         Text("LOOKAHEAD").font(.caption).foregroundStyle(.secondary)
-                        ArcKnob(value: $viewModel.limiterLookahead, range: 0.1...5.0, title: "ms")
+                        ArcKnob(value: $viewModel.limiterLookahead, range: 0.1...10.0, title: "ms")
                             .frame(width: 60, height: 60)
                     }
+                    VStack(spacing: 5) {
+                        Text("LINK").font(.caption).foregroundStyle(.secondary)
+                        Toggle("LINK", isOn: $viewModel.dynamicsLink)
+                            .toggleStyle(SwitchToggleStyle(tint: .blue))
+                            .labelsHidden()
+                    }
                 }
             }
         }
@@ -42,6 +42,20 @@ struct InputPanel: View {
                     .pickerStyle(SegmentedPickerStyle())
                     .frame(width: 80)
                 }
+                
+                VStack {
+                    Text("Oversampling")
+                        .font(.caption)
+                        .foregroundColor(.gray)
+                    Picker("Oversampling", selection: Binding(get: { Int(viewModel.oversampling) }, set: { viewModel.oversampling = Double($0) })) {
+                        Text("1x").tag(0)
+                        Text("2x").tag(1)
+                        Text("4x").tag(2)
+                        Text("8x").tag(3)
+                    }
+                    .pickerStyle(SegmentedPickerStyle())
+                    .frame(width: 140)
+                }
             }
         }
     }
@@ -75,6 +89,29 @@ struct PitchDeesserPanel: View {
                 HStack(spacing: 15) {
                     ArcKnob(value: $viewModel.pitchAmount, range: 0...100, title: "Amount", unit: "%")
                     ArcKnob(value: $viewModel.pitchSpeed, range: 0...100, title: "Speed", unit: "%")
+                    
+                    VStack {
+                        Text("Scale")
+                            .font(.caption)
+                            .foregroundColor(.gray)
+                        Picker("Key", selection: Binding(get: { Int(viewModel.pitchKey) }, set: { viewModel.pitchKey = Double($0) })) {
+                            ForEach(0..<12) { key in
+                                Text(PitchNotesRow.noteNames[key]).tag(key)
+                            }
+                        }
+                        .frame(width: 70)
+                        Picker("Scale", selection: Binding(get: { Int(viewModel.pitchScale) }, set: { viewModel.pitchScale = Double($0) })) {
+                            Text("Off").tag(0)
+                            Text("Chromatic").tag(1)
+                            Text("Major").tag(2)
+                            Text("Minor").tag(3)
+                            Text("Custom").tag(4)
+                        }
+                        .frame(width: 110)
+                    }
+                }
+                if Int(viewModel.pitchScale) == 4 {
+                    PitchNotesRow(viewModel: viewModel)
                 }
             }
             
@@ -90,6 +127,32 @@ struct PitchDeesserPanel: View {
     }
 }
 
+// Custom scale: one toggle per semitone above the key
+struct PitchNotesRow: View {
+    @ObservedObject var viewModel: AudioUnitViewModel
+    static let noteNames = ["C", "C#", "D", "D#", "E", "F", "F#", "G", "G#", "A", "A#", "B"]
+    
+    var body: some View {
+        HStack(spacing: 2) {
+            ForEach(0..<12) { degree in
+                let mask = Int(viewModel.pitchNotes)
+                let isOn = (mask >> degree) & 1 == 1
+                Button(action: {
+                    let toggled = mask ^ (1 << degree)
+                    if toggled != 0 { viewModel.pitchNotes = Double(toggled) }
+                }) {
+                    Text(PitchNotesRow.noteNames[(degree + Int(viewModel.pitchKey)) % 12])
+                        .font(.caption2)
+                        .frame(width: 22, height: 18)
+                        .background(isOn ? Color.orange.opacity(0.8) : Color.white.opacity(0.1))
+                        .cornerRadius(3)
+                }
+                .buttonStyle(PlainButtonStyle())
+            }
+        }
+    }
+}
+
 // --- 4. EQ Panel ---
 struct EQPanel: View {
     @ObservedObject var viewModel: AudioUnitViewModel
@@ -164,7 +227,11 @@ struct DynamicsPanel: View {
             RackPanel(title: "Limiter", isEnabled: $viewModel.limiterEnable) {
                 HStack(spacing: 15) {
                     ArcKnob(value: $viewModel.limiterCeiling, range: -6...0, title: "Ceiling", unit: "dB")
-                    ArcKnob(value: $viewModel.limiterLookahead, range: 0...5, title: "Lookahead", unit: "ms")
+                    ArcKnob(value: $viewModel.limiterLookahead, range: 0...10, title: "Lookahead", unit: "ms")
+                    Toggle("Link", isOn: $viewModel.dynamicsLink)
+                        .toggleStyle(SwitchToggleStyle(tint: .cyan))
+                        .labelsHidden()
+                        .frame(width: 50)
                 }
             }
         }
@@ -0,0 +1,219 @@
+//
+//  ControlRateTest.cpp
+//  AIVTests
+//
+//  Created by AIV on 02/02/2026.
+//
+
+// Checks the control-rate processBlock() of every dynamics lane module, at
+// the two-lane width the kernel runs them, against a per-sample reference at
+// each interval and interpolation mode. The reference is the scalar module's
+// process(), one instance per channel; the linked compressor has no scalar
+// form, so its reference is written out below. The bounds are the ones
+// documented on ControlRateGain.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "AIVDSPLanes.hpp"
+
+namespace {
+
+const double kSampleRate = 48000.0;
+const int kLanes = 2;
+
+struct Bound {
+  int interval;
+  double errorDb; // output error at least this far below the signal
+  double gainDb;  // gain deviation for 99% of samples at most this
+};
+
+const Bound kBounds[] = {{8, 37.0, 0.05}, {16, 35.0, 0.05}, {32, 29.0, 0.1}};
+
+struct Stereo {
+  std::vector<float> channel[kLanes];
+};
+
+// Three levels 48 dB apart, switched every 100 ms without a ramp: the
+// worst case for a gain law that is only evaluated every interval. The
+// right channel steps through the levels in reverse, so a linked detector
+// follows each channel in turn.
+Stereo makeInput() {
+  const int length = (int)kSampleRate * 4;
+  Stereo x;
+  srand(1);
+  for (int c = 0; c < kLanes; ++c) {
+    x.channel[c].resize(length);
+    for (int i = 0; i < length; ++i) {
+      const int step = c == 0 ? (i / 4800) % 3 : 2 - (i / 4800) % 3;
+      const double level = step == 0 ? 0.9 : (step == 1 ? 0.2 : 0.003);
+      const double t = i / kSampleRate;
+      const double noise = rand() / (double)RAND_MAX - 0.5;
+      x.channel[c][i] =
+          (float)(level * (0.6 * std::sin(2.0 * kPi * 220.0 * t) +
+                           0.3 * std::sin(2.0 * kPi * 6000.0 * t) +
+                           0.1 * noise));
+    }
+  }
+  return x;
+}
+
+// One scalar module per channel, run a sample at a time
+template <class Module, class Setup>
+Stereo perSample(Setup setup, const Stereo &x) {
+  Stereo y(x);
+  for (int c = 0; c < kLanes; ++c) {
+    Module module;
+    setup(module);
+    for (float &v : y.channel[c])
+      v = module.process(v);
+  }
+  return y;
+}
+
+// Linked FET compressor, per sample: one detector on the louder driven
+// channel, one gain law for both
+Stereo linkedCompressor(const FETCompressorLanes<kLanes>::Coefficients &k,
+                        const Stereo &x) {
+  const double threshold = 0.1; // -20dB, as in FETCompressorLanes
+  Stereo y(x);
+  double envelope = 0.0;
+  for (size_t i = 0; i < x.channel[0].size(); ++i) {
+    float peak = 0.0f;
+    for (int c = 0; c < kLanes; ++c) {
+      y.channel[c][i] *= (float)k.inputGain;
+      peak = std::max(peak, std::fabs(y.channel[c][i]));
+    }
+    const double coeff = peak > envelope ? k.attackCoeff : k.releaseCoeff;
+    envelope = coeff * (envelope - peak) + peak;
+    float gain = 1.0f;
+    if (envelope > threshold)
+      gain = FastMath::pow((float)(envelope / threshold), k.grExponent);
+    for (int c = 0; c < kLanes; ++c)
+      y.channel[c][i] = (float)(y.channel[c][i] * gain * k.makeupGain);
+  }
+  return y;
+}
+
+template <class Module, class Setup>
+bool check(const char *name, Setup setup, const Stereo &x,
+           const Stereo &expected) {
+  bool passed = true;
+  const int length = (int)x.channel[0].size();
+  for (const Bound &bound : kBounds) {
+    for (auto mode : {ControlRateGain::Linear, ControlRateGain::Cubic}) {
+      Module block;
+      setup(block);
+      block.setControlRate(bound.interval, mode);
+
+      std::vector<float> frames(length * kLanes);
+      const float *in[kLanes] = {x.channel[0].data(), x.channel[1].data()};
+      for (int i = 0; i < length; ++i)
+        for (int c = 0; c < kLanes; ++c)
+          frames[i * kLanes + c] = in[c][i];
+      // Host blocks of uneven sizes, so segments are cut short at their ends
+      for (int done = 0; done < length;) {
+        const int n = std::min(length - done, 1 + (done * 7) % 500);
+        block.processBlock(frames.data() + done * kLanes, n);
+        done += n;
+      }
+
+      double signal = 0.0, error = 0.0;
+      std::vector<double> deviations;
+      for (int c = 0; c < kLanes; ++c) {
+        for (int i = 0; i < length; ++i) {
+          const float input = x.channel[c][i];
+          const float want = expected.channel[c][i];
+          const float got = frames[i * kLanes + c];
+          signal += (double)want * want;
+          const double e = (double)want - got;
+          error += e * e;
+          if (std::fabs(input) > 1e-3f) {
+            const double g1 = want / input, g2 = got / input;
+            if (g1 > 1e-4 && g2 > 1e-4)
+              deviations.push_back(std::fabs(20.0 * std::log10(g2 / g1)));
+          }
+        }
+      }
+      std::sort(deviations.begin(), deviations.end());
+      const double errorDb =
+          error > 0.0 ? 10.0 * std::log10(signal / error) : HUGE_VAL;
+      const double gainDb =
+          deviations.empty() ? 0.0 : deviations[deviations.size() * 99 / 100];
+
+      const bool ok = errorDb >= bound.errorDb && gainDb <= bound.gainDb;
+      printf("%-18s N=%2d %-6s error %5.1f dB below signal (>= %.0f), "
+             "gain p99 %.3f dB (<= %.2f)%s\n",
+             name, bound.interval,
+             mode == ControlRateGain::Cubic ? "cubic" : "linear", errorDb,
+             bound.errorDb, gainDb, bound.gainDb, ok ? "" : "  FAILED");
+      passed = passed && ok;
+    }
+  }
+  return passed;
+}
+
+} // namespace
+
+int main() {
+  const Stereo x = makeInput();
+  const double fs = kSampleRate;
+  bool passed = true;
+
+  passed &= check<FETCompressorLanes<kLanes>>(
+      "FETCompressor",
+      [&](FETCompressorLanes<kLanes> &c) {
+        c.setParameters(6.0, 4.0, 0.4, 100.0, 0.0, fs);
+      },
+      x,
+      perSample<FETCompressor>(
+          [&](FETCompressor &c) {
+            c.setParameters(6.0, 4.0, 0.4, 100.0, 0.0, fs);
+            c.setThresholdOffset(0.0);
+          },
+          x));
+
+  const auto linked = FETCompressorLanes<kLanes>::design(
+      6.0, 4.0, 0.4, 100.0, 0.0, false, true, fs);
+  passed &= check<FETCompressorLanes<kLanes>>(
+      "FETCompressor link",
+      [&](FETCompressorLanes<kLanes> &c) { c.setCoefficients(linked); }, x,
+      linkedCompressor(linked, x));
+
+  passed &= check<DeesserLanes<kLanes>>(
+      "Deesser",
+      [&](DeesserLanes<kLanes> &d) {
+        d.setParameters(-30.0, 5000.0, -12.0, 5.0, fs);
+      },
+      x,
+      perSample<Deesser>(
+          [&](Deesser &d) { d.setParameters(-30.0, 5000.0, -12.0, 5.0, fs); },
+          x));
+
+  passed &= check<NoiseGateLanes<kLanes>>(
+      "NoiseGate",
+      [&](NoiseGateLanes<kLanes> &g) {
+        g.setParameters(-30.0, -40.0, 1.0, 50.0, 100.0, 6.0, fs);
+      },
+      x,
+      perSample<NoiseGate>(
+          [&](NoiseGate &g) {
+            g.setParameters(-30.0, -40.0, 1.0, 50.0, 100.0, 6.0, fs);
+          },
+          x));
+
+  passed &= check<AutoLevelLanes<kLanes>>(
+      "AutoLevel",
+      [&](AutoLevelLanes<kLanes> &a) {
+        a.setParameters(-10.0, 12.0, 50.0, fs);
+      },
+      x,
+      perSample<AutoLevel>(
+          [&](AutoLevel &a) { a.setParameters(-10.0, 12.0, 50.0, fs); }, x));
+
+  printf(passed ? "All within bounds\n" : "Out of bounds\n");
+  return passed ? 0 : 1;
+}
@@ -0,0 +1,399 @@
+//
+//  DSPBench.cpp
+//  AIVTests
+//
+//  Created by AIV on 02/02/2026.
+//
+
+// Benchmarks for the Support DSP, each with a pass/fail check so ctest can
+// run them. Pass section names to run only some:
+//   DSPBench [fft] [convolution] [silence]
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <thread>
+#include <vector>
+
+#include "AIVConvolution.hpp"
+#include "AIVDSPClasses.hpp"
+#include "AIVFFT.hpp"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+const double kTwoPi = 6.28318530717958647692;
+
+double microseconds(Clock::time_point start) {
+  return std::chrono::duration<double, std::micro>(Clock::now() - start)
+      .count();
+}
+
+// CPU time of the calling thread: unlike wall time it leaves out any time
+// the thread was preempted, by the convolution worker for one
+double threadMicroseconds() {
+  timespec now;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+  return now.tv_sec * 1e6 + now.tv_nsec / 1e3;
+}
+
+std::vector<float> noise(int length, unsigned seed) {
+  std::vector<float> x(length);
+  srand(seed);
+  for (auto &v : x)
+    v = rand() / (float)RAND_MAX - 0.5f;
+  return x;
+}
+
+// --- FFT ---
+// RealFFT against a naive DFT in double: the spectrum, the round trip and
+// the packed in-place layout, then the time of a forward + inverse pair.
+// The DFT is O(N^2), so it is only run up to kMaxDFTSize.
+
+// Naive real DFT, bins 0..N/2, with a twiddle table indexed by (k * n) % N
+void naiveDFT(const std::vector<float> &x, std::vector<double> &re,
+              std::vector<double> &im) {
+  const int size = (int)x.size();
+  std::vector<double> cosTable(size), sinTable(size);
+  for (int i = 0; i < size; ++i) {
+    cosTable[i] = std::cos(kTwoPi * i / size);
+    sinTable[i] = std::sin(kTwoPi * i / size);
+  }
+  re.assign(size / 2 + 1, 0.0);
+  im.assign(size / 2 + 1, 0.0);
+  for (int k = 0; k <= size / 2; ++k) {
+    double sumRe = 0.0, sumIm = 0.0;
+    long index = 0;
+    for (int n = 0; n < size; ++n) {
+      sumRe += x[n] * cosTable[index];
+      sumIm -= x[n] * sinTable[index];
+      index += k;
+      if (index >= size)
+        index -= size;
+    }
+    re[k] = sumRe;
+    im[k] = sumIm;
+  }
+}
+
+bool benchFFT() {
+  static const int kMaxDFTSize = 4096;
+  static const double kMaxError = 1e-5; // relative to the largest bin
+  bool passed = true;
+
+  printf("FFT: RealFFT against a naive DFT\n");
+  printf("%8s %11s %11s %11s %12s %12s %9s\n", "size", "spectrum",
+         "round trip", "packed", "fft us", "dft us", "speed-up");
+  for (int size = 64; size <= 65536; size *= 2) {
+    const int bins = size / 2 + 1;
+    const std::vector<float> x = noise(size, (unsigned)size);
+    RealFFT fft(size);
+    std::vector<float> re(bins), im(bins), y(size);
+
+    // Spectrum, against the DFT where it is affordable
+    fft.forward(x.data(), re.data(), im.data());
+    double spectrumError = 0.0, dftMicros = 0.0;
+    if (size <= kMaxDFTSize) {
+      std::vector<double> refRe, refIm;
+      const auto start = Clock::now();
+      naiveDFT(x, refRe, refIm);
+      dftMicros = microseconds(start);
+      double peak = 0.0, error = 0.0;
+      for (int k = 0; k < bins; ++k) {
+        peak = std::max(peak, std::hypot(refRe[k], refIm[k]));
+        error = std::max(error, std::hypot(refRe[k] - re[k], refIm[k] - im[k]));
+      }
+      spectrumError = error / peak;
+    }
+
+    // Round trip through the split spectrum
+    fft.inverse(re.data(), im.data(), y.data());
+    double roundTrip = 0.0;
+    for (int n = 0; n < size; ++n)
+      roundTrip = std::max(roundTrip, (double)std::fabs(y[n] - x[n]));
+
+    // In place, packed: re[0], re[N/2], then re/im pairs
+    std::vector<float> packed(x);
+    fft.forward(packed.data());
+    double packedError =
+        std::fabs(packed[0] - re[0]) + std::fabs(packed[1] - re[size / 2]);
+    for (int k = 1; k < size / 2; ++k)
+      packedError = std::max(packedError,
+                             (double)(std::fabs(packed[2 * k] - re[k]) +
+                                      std::fabs(packed[2 * k + 1] - im[k])));
+    fft.inverse(packed.data());
+    for (int n = 0; n < size; ++n)
+      packedError =
+          std::max(packedError, (double)std::fabs(packed[n] - x[n]));
+
+    // Forward + inverse, repeated to about 4M samples
+    const int repeats = std::max(1, (1 << 22) / size);
+    const auto start = Clock::now();
+    for (int r = 0; r < repeats; ++r) {
+      fft.forward(x.data(), re.data(), im.data());
+      fft.inverse(re.data(), im.data(), y.data());
+    }
+    const double fftMicros = microseconds(start) / repeats;
+
+    const bool ok = spectrumError < kMaxError && roundTrip < kMaxError &&
+                    packedError < kMaxError &&
+                    (dftMicros == 0.0 || fftMicros < dftMicros);
+    if (dftMicros > 0.0)
+      printf("%8d %11.2e %11.2e %11.2e %12.1f %12.1f %8.0fx%s\n", size,
+             spectrumError, roundTrip, packedError, fftMicros, dftMicros,
+             dftMicros / fftMicros, ok ? "" : "  FAILED");
+    else
+      printf("%8d %11s %11.2e %11.2e %12.1f %12s %9s%s\n", size, "-",
+             roundTrip, packedError, fftMicros, "-", "-",
+             ok ? "" : "  FAILED");
+    passed = passed && ok;
+  }
+
+  // Plans are shared by size while any instance holds one
+  const auto plan = FFTPlan::get(1024);
+  const bool shared = FFTPlan::get(1024) == plan;
+  printf("plan shared between instances: %s\n", shared ? "yes" : "no");
+  return passed && shared;
+}
+
+// --- Convolution ---
+// ConvolutionReverb against impulse response length (1 s, 3 s, 8 s at
+// 48k, stereo). The render thread's cost should not grow with the
+// response: beyond the head segment everything is the worker's. Reports
+// the render thread's CPU time per host block and the worker's load, the
+// time of one tail job against the tail block it has to fit in. First the
+// output is checked against direct convolution in double, on a response
+// that reaches into the tail and with host blocks that do not line up
+// with the partitions. That render is paced at real time, so the worker
+// meets every deadline as it would in a host, and must miss none.
+
+bool checkConvolution() {
+  static const double kSampleRate = 48000.0;
+  static const int kLength = 9000; // past 3 * kTailBlock: head and tail
+  static const int kFrames = 24000;
+  static const float kMix = 0.5f;
+  static const double kMaxError = 1e-5;
+
+  std::vector<float> response[2] = {noise(kLength, 5), noise(kLength, 6)};
+  for (auto &h : response)
+    for (int i = 0; i < kLength; ++i)
+      h[i] *= std::exp(-6.9f * i / kLength);
+  const float *impulse[2] = {response[0].data(), response[1].data()};
+  // The engine scales the response to unit energy on the louder channel
+  double energy = 0.0;
+  for (auto &h : response) {
+    double sum = 0.0;
+    for (float v : h)
+      sum += (double)v * v;
+    energy = std::max(energy, sum);
+  }
+  const double scale = 1.0 / std::sqrt(energy);
+
+  const std::vector<float> input[2] = {noise(kFrames, 7), noise(kFrames, 8)};
+  std::vector<double> expected[2];
+  for (int c = 0; c < 2; ++c) {
+    expected[c].resize(kFrames);
+    for (int n = 0; n < kFrames; ++n) {
+      double wet = 0.0;
+      for (int k = 0; k <= std::min(n, kLength - 1); ++k)
+        wet += (double)response[c][k] * input[c][n - k];
+      expected[c][n] = (1.0 - kMix) * input[c][n] + kMix * wet * scale;
+    }
+  }
+
+  bool passed = true;
+  for (int hostBlock : {100, 333}) {
+    ConvolutionReverb reverb(impulse, 2, kLength);
+    std::vector<float> out[2] = {std::vector<float>(kFrames),
+                                 std::vector<float>(kFrames)};
+    const auto start = Clock::now();
+    for (int done = 0; done < kFrames; done += hostBlock) {
+      const int n = std::min(hostBlock, kFrames - done);
+      reverb.process(input[0].data() + done, input[1].data() + done,
+                     out[0].data() + done, out[1].data() + done, n, kMix);
+      std::this_thread::sleep_until(
+          start + std::chrono::microseconds(
+                      (long long)((done + n) / kSampleRate * 1e6)));
+    }
+
+    double maxError = 0.0;
+    for (int c = 0; c < 2; ++c)
+      for (int n = 0; n < kFrames; ++n)
+        maxError = std::max(maxError, std::fabs(out[c][n] - expected[c][n]));
+    const unsigned missed = reverb.missedTailBlocks();
+    const bool ok = maxError < kMaxError && missed == 0;
+    printf("%d-frame blocks: max error %.2e against direct convolution "
+           "(< %.0e), %u tail blocks missed%s\n",
+           hostBlock, maxError, kMaxError, missed, ok ? "" : "  FAILED");
+    passed = passed && ok;
+  }
+  return passed;
+}
+
+bool benchConvolution() {
+  static const double kSampleRate = 48000.0;
+  static const int kHostBlock = 128;
+  static const int kRenderSeconds = 10;
+  static const double kMaxRenderGrowth = 2.0; // 8 s against 1 s
+  const int tailBlock = ConvolutionReverb::kTailBlock;
+  bool passed = checkConvolution();
+
+  printf("Convolution: render and worker cost against response length\n");
+  printf("%8s %10s %14s %14s %12s\n", "length", "build ms",
+         "render us/blk", "worst us/blk", "worker load");
+  double firstRender = 0.0, lastRender = 0.0;
+  for (int seconds : {1, 3, 8}) {
+    const int length = (int)kSampleRate * seconds;
+    std::vector<float> left = noise(length, 1), right = noise(length, 2);
+    for (int i = 0; i < length; ++i) {
+      const float decay = std::exp(-6.9f * i / length); // -60 dB at the end
+      left[i] *= decay;
+      right[i] *= decay;
+    }
+    const float *impulse[2] = {left.data(), right.data()};
+
+    auto start = Clock::now();
+    ConvolutionReverb reverb(impulse, 2, length);
+    const double buildMillis = microseconds(start) / 1000.0;
+
+    // Render thread, unpaced: the worker falls behind and drops blocks,
+    // which leaves the render thread's own cost unchanged
+    const int frames = (int)kSampleRate * kRenderSeconds;
+    const std::vector<float> input = noise(frames, 3);
+    std::vector<float> outL(kHostBlock), outR(kHostBlock);
+    double total = 0.0, worst = 0.0;
+    int blocks = 0;
+    for (int done = 0; done + kHostBlock <= frames; done += kHostBlock) {
+      const double blockStart = threadMicroseconds();
+      reverb.process(input.data() + done, input.data() + done, outL.data(),
+                     outR.data(), kHostBlock, 0.3f);
+      const double micros = threadMicroseconds() - blockStart;
+      total += micros;
+      worst = std::max(worst, micros);
+      ++blocks;
+    }
+    const double render = total / blocks;
+
+    // Worker: one tail job per channel, as the worker runs it
+    const int tailLength = std::max(0, length - 3 * tailBlock);
+    PartitionedConvolver tail[2];
+    tail[0].initialize(left.data() + 3 * tailBlock, tailLength, tailBlock);
+    tail[1].initialize(right.data() + 3 * tailBlock, tailLength, tailBlock);
+    std::vector<float> window = noise(2 * tailBlock, 4), result(tailBlock);
+    const int jobs = 50;
+    start = Clock::now();
+    for (int job = 0; job < jobs; ++job)
+      for (auto &t : tail)
+        t.process(window.data(), result.data());
+    const double jobMicros = microseconds(start) / jobs;
+    const double load = jobMicros / (tailBlock / kSampleRate * 1e6);
+
+    printf("%6d s %10.1f %14.2f %14.1f %11.1f%%\n", seconds, buildMillis,
+           render, worst, load * 100.0);
+    if (seconds == 1)
+      firstRender = render;
+    lastRender = render;
+    passed = passed && load < 1.0;
+  }
+
+  const bool flat = lastRender < firstRender * kMaxRenderGrowth;
+  printf("render cost 8 s / 1 s: %.2fx (< %.1fx)\n", lastRender / firstRender,
+         kMaxRenderGrowth);
+  return passed && flat;
+}
+
+// --- Decaying Silence ---
+// One impulse, then silence, through the feedback paths that used to decay
+// into subnormals: the ZDF and biquad filter states, a delay line with
+// feedback and the reverb network. Runs without ScopedNoDenormals, so it
+// is the flushes in the loops that keep the per-block time flat; the time
+// late in the decay, long past where the states would have gone
+// subnormal, is compared with the time right after the impulse.
+
+bool benchSilence() {
+  static const double kSampleRate = 48000.0;
+  static const int kBlock = 512;
+  static const int kSeconds = 30;
+  static const double kMaxSlowdown = 2.0;
+
+  ZDFFilter zdf;
+  zdf.setParameters(ZDFFilter::LowPass, 200.0, 0.707, 0.0, kSampleRate);
+  BiquadFilter biquad;
+  biquad.calculateCoefficients(BiquadFilter::LowPass, 200.0, 0.707, 0.0,
+                               kSampleRate);
+  DelayLine delay;
+  delay.initialize(kSampleRate);
+  delay.setCoefficients(DelayLine::design(0.05, 70.0, 50.0, kSampleRate));
+  MultirateReverb reverb;
+  reverb.initialize(kSampleRate);
+  reverb.setCoefficients(
+      MultirateReverb::design(30.0, 50.0, 100.0, kSampleRate));
+
+  const int blocks = (int)(kSeconds * kSampleRate) / kBlock;
+  std::vector<float> buffer(kBlock), wet(kBlock);
+  std::vector<double> times(blocks);
+  float last = 0.0f;
+  for (int b = 0; b < blocks; ++b) {
+    std::fill(buffer.begin(), buffer.end(), 0.0f);
+    if (b == 0)
+      buffer[0] = 1.0f;
+    const double start = threadMicroseconds();
+    zdf.processBlock(buffer.data(), kBlock);
+    biquad.processBlock(buffer.data(), kBlock);
+    delay.processBlock(buffer.data(), kBlock);
+    reverb.process(buffer.data(), wet.data(), kBlock);
+    times[b] = threadMicroseconds() - start;
+    last = std::max(std::fabs(wet[kBlock - 1]), std::fabs(buffer[kBlock - 1]));
+  }
+
+  // Medians, so a preempted block does not count: the first second after
+  // the impulse against the last quarter
+  auto median = [&](int from, int to) {
+    std::vector<double> span(times.begin() + from, times.begin() + to);
+    std::nth_element(span.begin(), span.begin() + span.size() / 2,
+                     span.end());
+    return span[span.size() / 2];
+  };
+  const int second = (int)kSampleRate / kBlock;
+  const double early = median(1, 1 + second);
+  const double late = median(blocks - blocks / 4, blocks);
+
+  printf("Decaying silence: %d s in %d-sample blocks, no FTZ\n", kSeconds,
+         kBlock);
+  printf("  first second     %8.2f us/blk\n", early);
+  printf("  last quarter     %8.2f us/blk (%.2fx, < %.1fx)\n", late,
+         late / early, kMaxSlowdown);
+  printf("  final output     %8.1e\n", last);
+  return late < early * kMaxSlowdown;
+}
+
+struct Section {
+  const char *name;
+  bool (*run)();
+};
+
+const Section kSections[] = {{"fft", benchFFT},
+                             {"convolution", benchConvolution},
+                             {"silence", benchSilence}};
+
+} // namespace
+
+int main(int argc, char **argv) {
+  bool passed = true;
+  for (const Section &section : kSections) {
+    bool selected = argc < 2;
+    for (int i = 1; i < argc; ++i)
+      selected = selected || std::strcmp(argv[i], section.name) == 0;
+    if (!selected)
+      continue;
+    const bool ok = section.run();
+    printf("%s: %s\n\n", section.name, ok ? "passed" : "FAILED");
+    passed = passed && ok;
+  }
+  return passed ? 0 : 1;
+}
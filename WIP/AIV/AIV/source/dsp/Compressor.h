@@ -7,6 +7,8 @@
 #include <algorithm>
 #include <cmath>
 
+#include "FastMath.h"
+
 namespace AIV {
 namespace DSP {
 
@@ -48,14 +50,15 @@ public:
   void process(float *left, float *right, int numSamples) {
     for (int i = 0; i < numSamples; ++i) {
       // Detect level (peak to dB)
-      double input = std::max(std::fabs(left[i]), std::fabs(right[i]));
-      double inputDb = (input > 1e-6) ? 20.0 * std::log10(input) : -120.0;
+      // Floored at -120dB
+      float input = std::max(std::fabs(left[i]), std::fabs(right[i]));
+      double inputDb = FastMath::linToDb(std::max(input, 1e-6f));
 
       // Compute gain reduction with soft knee
       double gainReductionDb = computeGainReduction(inputDb);
 
       // Envelope follower for gain
-      double targetEnv = std::pow(10.0, gainReductionDb / 20.0);
+      double targetEnv = FastMath::dbToLin((float)gainReductionDb);
       if (targetEnv < mEnvelope)
         mEnvelope = mAttackCoeff * mEnvelope + (1.0 - mAttackCoeff) * targetEnv;
       else
@@ -7,6 +7,8 @@
 #include <algorithm>
 #include <cmath>
 
+#include "Denormals.h"
+
 namespace AIV {
 namespace DSP {
 
@@ -88,9 +90,10 @@ private:
   }
 
   double applyBandpass(double input) {
-    double output = mB[0] * input + mB[1] * mBandpassState[0] +
-                    mB[2] * mBandpassState[1] - mA[1] * mBandpassState[2] -
-                    mA[2] * mBandpassState[3];
+    double output = flushDenormal(
+        mB[0] * input + mB[1] * mBandpassState[0] +
+        mB[2] * mBandpassState[1] - mA[1] * mBandpassState[2] -
+        mA[2] * mBandpassState[3]);
 
     mBandpassState[1] = mBandpassState[0];
     mBandpassState[0] = input;
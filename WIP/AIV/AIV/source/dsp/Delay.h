@@ -8,30 +8,41 @@
 #include <cmath>
 #include <vector>
 
+#include "Denormals.h"
+
 namespace AIV {
 namespace DSP {
 
 //------------------------------------------------------------------------
 // Delay - Stereo delay with feedback and filtering
+//
+// The lines are power-of-two rings addressed with a mask, and each block is
+// cut into spans that neither wrap nor read what the same span writes.
+// Within a span the delayed samples are contiguous, so without feedback the
+// line is a straight copy; with feedback only the lowpass recursion is
+// serial.
 //------------------------------------------------------------------------
 class Delay {
 public:
   void reset(double sampleRate) {
     mSampleRate = sampleRate;
-    int maxDelaySamples = static_cast<int>(sampleRate * 2.0); // 2 seconds max
-    mBufferL.resize(static_cast<size_t>(maxDelaySamples));
-    mBufferR.resize(static_cast<size_t>(maxDelaySamples));
-    std::fill(mBufferL.begin(), mBufferL.end(), 0.0f);
-    std::fill(mBufferR.begin(), mBufferR.end(), 0.0f);
+    // 2 seconds max, rounded up to a power of two
+    const int maxDelaySamples = static_cast<int>(sampleRate * 2.0);
+    int size = 1;
+    while (size <= maxDelaySamples)
+      size <<= 1;
+    mMask = size - 1;
+    mBufferL.assign(static_cast<size_t>(size), 0.0f);
+    mBufferR.assign(static_cast<size_t>(size), 0.0f);
     mWritePos = 0;
     mFilterStateL = mFilterStateR = 0.0;
   }
 
   void setParameters(float timeL, float timeR, float feedback, float mix,
                      float /*sync*/, float highpass, float lowpass) {
-    // time: 0-1 maps to 0ms to 1000ms
-    mDelaySamplesL = static_cast<int>(timeL * mSampleRate);
-    mDelaySamplesR = static_cast<int>(timeR * mSampleRate);
+    // time: 0-1 maps to 0ms to 1000ms, at least one sample
+    mDelaySamplesL = clampDelay(static_cast<int>(timeL * mSampleRate));
+    mDelaySamplesR = clampDelay(static_cast<int>(timeR * mSampleRate));
 
     // feedback: 0-1 maps to 0% to 95%
     mFeedback = feedback * 0.95;
@@ -48,43 +59,73 @@ public:
   }
 
   void process(float *left, float *right, int numSamples) {
-    int bufferSize = static_cast<int>(mBufferL.size());
-
-    for (int i = 0; i < numSamples; ++i) {
-      // Read from delay buffer
-      int readPosL = (mWritePos - mDelaySamplesL + bufferSize) % bufferSize;
-      int readPosR = (mWritePos - mDelaySamplesR + bufferSize) % bufferSize;
-
-      double delayedL = mBufferL[static_cast<size_t>(readPosL)];
-      double delayedR = mBufferR[static_cast<size_t>(readPosR)];
-
-      // Simple lowpass on delayed signal
-      mFilterStateL =
-          mLowpassCoeff * mFilterStateL + (1.0 - mLowpassCoeff) * delayedL;
-      mFilterStateR =
-          mLowpassCoeff * mFilterStateR + (1.0 - mLowpassCoeff) * delayedR;
+    if (mBufferL.empty())
+      return;
+    processChannel(left, mBufferL.data(), mDelaySamplesL, mFilterStateL,
+                   numSamples);
+    processChannel(right, mBufferR.data(), mDelaySamplesR, mFilterStateR,
+                   numSamples);
+    mWritePos = (mWritePos + numSamples) & mMask;
+  }
 
-      // Write to buffer with feedback
-      mBufferL[static_cast<size_t>(mWritePos)] =
-          static_cast<float>(left[i] + mFilterStateL * mFeedback);
-      mBufferR[static_cast<size_t>(mWritePos)] =
-          static_cast<float>(right[i] + mFilterStateR * mFeedback);
+  // Samples until the echoes have decayed by 80 dB after the input stops
+  int getTailSamples() const {
+    const int delay = std::max(mDelaySamplesL, mDelaySamplesR);
+    int passes = 1;
+    if (mFeedback > 0.0)
+      passes +=
+          static_cast<int>(std::ceil(std::log(1e-4) / std::log(mFeedback)));
+    return passes * delay;
+  }
 
-      // Mix output
-      left[i] = static_cast<float>(left[i] * (1.0 - mMix) + delayedL * mMix);
-      right[i] = static_cast<float>(right[i] * (1.0 - mMix) + delayedR * mMix);
+private:
+  int clampDelay(int samples) const {
+    return std::max(1, std::min(samples, mMask));
+  }
 
-      mWritePos = (mWritePos + 1) % bufferSize;
+  void processChannel(float *io, float *buffer, int delay, double &state,
+                      int numSamples) const {
+    const int size = mMask + 1;
+    const float mix = static_cast<float>(mMix);
+    const float dry = 1.0f - mix;
+    int writePos = mWritePos;
+    int done = 0;
+    while (done < numSamples) {
+      const int readPos = (writePos - delay) & mMask;
+      int n = std::min(numSamples - done, delay);
+      n = std::min(n, size - writePos);
+      n = std::min(n, size - readPos);
+
+      const float *delayed = buffer + readPos;
+      float *write = buffer + writePos;
+      float *x = io + done;
+      if (mFeedback == 0.0) {
+        for (int i = 0; i < n; ++i) {
+          write[i] = x[i];
+          x[i] = x[i] * dry + delayed[i] * mix;
+        }
+      } else {
+        // Simple lowpass on the delayed signal, into the feedback path
+        for (int i = 0; i < n; ++i) {
+          state = flushDenormal(mLowpassCoeff * state +
+                                (1.0 - mLowpassCoeff) * delayed[i]);
+          write[i] =
+              flushDenormal(static_cast<float>(x[i] + state * mFeedback));
+          x[i] = x[i] * dry + delayed[i] * mix;
+        }
+      }
+      writePos = (writePos + n) & mMask;
+      done += n;
     }
   }
 
-private:
   double mSampleRate = 44100.0;
   std::vector<float> mBufferL;
   std::vector<float> mBufferR;
+  int mMask = 0;
   int mWritePos = 0;
-  int mDelaySamplesL = 0;
-  int mDelaySamplesR = 0;
+  int mDelaySamplesL = 1;
+  int mDelaySamplesR = 1;
   double mFeedback = 0.3;
   double mMix = 0.3;
   double mHighpassCoeff = 0.99;
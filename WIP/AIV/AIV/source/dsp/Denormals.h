@@ -0,0 +1,71 @@
+//------------------------------------------------------------------------
+// Copyright(c) 2026 AIV.
+//------------------------------------------------------------------------
+
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+
+#if defined(__SSE__) || defined(__x86_64__) || defined(_M_X64)
+#include <xmmintrin.h>
+#define AIV_DENORMALS_SSE 1
+#elif defined(__aarch64__) && !defined(_MSC_VER)
+#define AIV_DENORMALS_ARM64 1
+#endif
+
+namespace AIV {
+namespace DSP {
+
+//------------------------------------------------------------------------
+// ScopedNoDenormals - Flush-to-zero for the lifetime of a process() call
+//------------------------------------------------------------------------
+// Feedback loops fed silence decay through the subnormal range, which is
+// 10-100x slower on x86. Sets FTZ (and DAZ on x86) and restores the host's
+// mode on scope exit.
+class ScopedNoDenormals {
+public:
+  ScopedNoDenormals() {
+#if AIV_DENORMALS_SSE
+    mSaved = _mm_getcsr();
+    _mm_setcsr(mSaved | 0x8040); // FTZ | DAZ
+#elif AIV_DENORMALS_ARM64
+    asm volatile("mrs %0, fpcr" : "=r"(mSaved));
+    asm volatile("msr fpcr, %0" : : "r"(mSaved | (uint64_t(1) << 24)));
+#endif
+  }
+
+  ~ScopedNoDenormals() {
+#if AIV_DENORMALS_SSE
+    _mm_setcsr(mSaved);
+#elif AIV_DENORMALS_ARM64
+    asm volatile("msr fpcr, %0" : : "r"(mSaved));
+#endif
+  }
+
+  ScopedNoDenormals(const ScopedNoDenormals &) = delete;
+  ScopedNoDenormals &operator=(const ScopedNoDenormals &) = delete;
+
+private:
+#if AIV_DENORMALS_SSE
+  unsigned int mSaved = 0;
+#elif AIV_DENORMALS_ARM64
+  uint64_t mSaved = 0;
+#endif
+};
+
+//------------------------------------------------------------------------
+// flushDenormal - Zeroes recursive state below about -300 dBFS, so feedback
+// loops stay fast in builds or threads without FTZ
+//------------------------------------------------------------------------
+inline float flushDenormal(float x) {
+  return std::fabs(x) < 1e-15f ? 0.0f : x;
+}
+
+inline double flushDenormal(double x) {
+  return std::fabs(x) < 1e-15 ? 0.0 : x;
+}
+
+//------------------------------------------------------------------------
+} // namespace DSP
+} // namespace AIV
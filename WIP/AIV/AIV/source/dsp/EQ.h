@@ -7,6 +7,8 @@
 #include <algorithm>
 #include <cmath>
 
+#include "Denormals.h"
+
 namespace AIV {
 namespace DSP {
 
@@ -95,8 +97,8 @@ public:
     for (int i = 0; i < numSamples; ++i) {
       // Left channel
       double inL = left[i];
-      double outL =
-          mB0 * inL + mB1 * mX1L + mB2 * mX2L - mA1 * mY1L - mA2 * mY2L;
+      double outL = flushDenormal(mB0 * inL + mB1 * mX1L + mB2 * mX2L -
+                                  mA1 * mY1L - mA2 * mY2L);
       mX2L = mX1L;
       mX1L = inL;
       mY2L = mY1L;
@@ -105,8 +107,8 @@ public:
 
       // Right channel
       double inR = right[i];
-      double outR =
-          mB0 * inR + mB1 * mX1R + mB2 * mX2R - mA1 * mY1R - mA2 * mY2R;
+      double outR = flushDenormal(mB0 * inR + mB1 * mX1R + mB2 * mX2R -
+                                  mA1 * mY1R - mA2 * mY2R);
       mX2R = mX1R;
       mX1R = inR;
       mY2R = mY1R;
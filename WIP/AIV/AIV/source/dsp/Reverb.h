@@ -8,6 +8,8 @@
 #include <cmath>
 #include <vector>
 
+#include "Denormals.h"
+
 namespace AIV {
 namespace DSP {
 
@@ -84,8 +86,8 @@ public:
         double output = mCombBuffers[c][static_cast<size_t>(mCombPos[c])];
 
         // Lowpass filter in feedback path (damping)
-        mCombFilterStore[c] =
-            output * (1.0 - mDamping) + mCombFilterStore[c] * mDamping;
+        mCombFilterStore[c] = flushDenormal(output * (1.0 - mDamping) +
+                                            mCombFilterStore[c] * mDamping);
 
         mCombBuffers[c][static_cast<size_t>(mCombPos[c])] =
             static_cast<float>(predelayed + mCombFilterStore[c] * mFeedback);
@@ -100,7 +102,7 @@ public:
       for (int a = 0; a < 4; ++a) {
         int bufSize = static_cast<int>(mAllpassBuffers[a].size());
         double bufOut = mAllpassBuffers[a][static_cast<size_t>(mAllpassPos[a])];
-        double newVal = allpassOut + bufOut * 0.5;
+        double newVal = flushDenormal(allpassOut + bufOut * 0.5);
 
         mAllpassBuffers[a][static_cast<size_t>(mAllpassPos[a])] =
             static_cast<float>(newVal);
@@ -116,6 +118,22 @@ public:
     }
   }
 
+  // Samples until the tail has decayed by 80 dB after the input stops
+  int getTailSamples() const {
+    size_t longestComb = 0;
+    for (const auto &buffer : mCombBuffers)
+      longestComb = std::max(longestComb, buffer.size());
+    // The allpasses ring on at half gain per pass
+    size_t allpasses = 0;
+    for (const auto &buffer : mAllpassBuffers)
+      allpasses += buffer.size();
+    const double combPasses = std::ceil(std::log(1e-4) / std::log(mFeedback));
+    const double allpassPasses = std::ceil(std::log(1e-4) / std::log(0.5));
+    return mPredelaySamples +
+           static_cast<int>(combPasses * longestComb +
+                            allpassPasses * allpasses);
+  }
+
 private:
   double mSampleRate = 44100.0;
 
@@ -74,6 +74,7 @@ tresult PLUGIN_API AIVProcessor::setActive(TBool state) {
 
     // Update DSP with current parameters
     updateDSPParameters();
+    mSilentSamples = 0;
   }
 
   //--- called when the Plug-in is enable/disable (On/Off) -----
@@ -106,6 +107,10 @@ void AIVProcessor::updateDSPParameters() {
 
 //------------------------------------------------------------------------
 tresult PLUGIN_API AIVProcessor::process(Vst::ProcessData &data) {
+  // Decaying feedback tails stay out of the subnormal range; the host's
+  // floating-point mode is restored on return
+  AIV::DSP::ScopedNoDenormals noDenormals;
+
   //--- First : Read inputs parameter changes-----------
   if (data.inputParameterChanges) {
     int32 numParamsChanged = data.inputParameterChanges->getParameterCount();
@@ -348,6 +353,29 @@ tresult PLUGIN_API AIVProcessor::process(Vst::ProcessData &data) {
 
     int32 numSamples = data.numSamples;
 
+    // Silent input: flagged by the host, or all zeros
+    const uint64 stereoMask = 3;
+    bool inputSilent =
+        (data.inputs[0].silenceFlags & stereoMask) == stereoMask;
+    if (!inputSilent) {
+      inputSilent = true;
+      for (int32 i = 0; i < numSamples && inputSilent; ++i)
+        inputSilent = inL[i] == 0.0f && inR[i] == 0.0f;
+    }
+    mSilentSamples = inputSilent ? mSilentSamples + numSamples : 0;
+
+    // Once the input has been silent for longer than the tail every module
+    // has rung out: skip the chain and report silence. Any non-silent
+    // input wakes it on the same block.
+    if (mSilentSamples > tailSamples()) {
+      if (outL != inL)
+        memset(outL, 0, static_cast<size_t>(numSamples) * sizeof(float));
+      if (outR != inR)
+        memset(outR, 0, static_cast<size_t>(numSamples) * sizeof(float));
+      data.outputs[0].silenceFlags = stereoMask;
+      return kResultOk;
+    }
+
     // Copy input to output if not in-place
     if (outL != inL)
       memcpy(outL, inL, static_cast<size_t>(numSamples) * sizeof(float));
@@ -422,6 +450,23 @@ tresult PLUGIN_API AIVProcessor::process(Vst::ProcessData &data) {
   return kResultOk;
 }
 
+//------------------------------------------------------------------------
+int32 AIVProcessor::tailSamples() const {
+  // Filters, envelopes and the pitch buffer settle within 100 ms; the
+  // delay and reverb ring on for as long as their feedback allows
+  int32 tail = static_cast<int32>(mSampleRate * 0.1);
+  if (mDelayEnabled)
+    tail += mDelay.getTailSamples();
+  if (mReverbEnabled)
+    tail += mReverb.getTailSamples();
+  return tail;
+}
+
+//------------------------------------------------------------------------
+uint32 PLUGIN_API AIVProcessor::getTailSamples() {
+  return static_cast<uint32>(tailSamples());
+}
+
 //------------------------------------------------------------------------
 tresult PLUGIN_API AIVProcessor::setupProcessing(Vst::ProcessSetup &newSetup) {
   mSampleRate = newSetup.sampleRate;
@@ -9,6 +9,7 @@
 #include "dsp/Compressor.h"
 #include "dsp/DeEsser.h"
 #include "dsp/Delay.h"
+#include "dsp/Denormals.h"
 #include "dsp/EQ.h"
 #include "dsp/Gate.h"
 #include "dsp/Pitch.h"
@@ -58,6 +59,9 @@ public:
   Steinberg::tresult PLUGIN_API process(Steinberg::Vst::ProcessData &data)
       SMTG_OVERRIDE;
 
+  /** Samples of output that follow the end of the input */
+  Steinberg::uint32 PLUGIN_API getTailSamples() SMTG_OVERRIDE;
+
   /** For persistence */
   Steinberg::tresult PLUGIN_API setState(Steinberg::IBStream *state)
       SMTG_OVERRIDE;
@@ -69,6 +73,9 @@ protected:
   // Sample rate
   double mSampleRate = 44100.0;
 
+  // Consecutive silent input samples; past the tail, processing sleeps
+  Steinberg::int64 mSilentSamples = 0;
+
   // DSP Modules
   AIV::DSP::Gate mGate;
   AIV::DSP::Compressor mCompressor;
@@ -171,6 +178,7 @@ protected:
 
   // Helper functions
   void updateDSPParameters();
+  Steinberg::int32 tailSamples() const;
 };
 
 //------------------------------------------------------------------------
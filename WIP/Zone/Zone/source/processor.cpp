@@ -10,6 +10,14 @@
 
 #include <algorithm>
 #include <cmath>
+#include <cstdint>
+
+#if defined(__SSE__) || defined(__x86_64__) || defined(_M_X64)
+#include <xmmintrin.h>
+#define ZONE_DENORMALS_SSE 1
+#elif defined(__aarch64__) && !defined(_MSC_VER)
+#define ZONE_DENORMALS_ARM64 1
+#endif
 
 using namespace Steinberg;
 
@@ -18,6 +26,47 @@ namespace MyCompanyName {
 // Define the static constexpr member
 constexpr int ZoneProcessor::kReverbDelayTimes[kReverbDelayLines];
 
+namespace {
+//------------------------------------------------------------------------
+// Denormal protection: the shimmer and reverb loops decay through the
+// subnormal range once the input goes quiet, which is 10-100x slower on
+// x86. process() runs with flush-to-zero (and DAZ on x86) and restores the
+// host's mode on return; the loop states are also zeroed once they are far
+// below audible level, for builds or threads without FTZ.
+//------------------------------------------------------------------------
+class ScopedNoDenormals {
+public:
+  ScopedNoDenormals() {
+#if ZONE_DENORMALS_SSE
+    mSaved = _mm_getcsr();
+    _mm_setcsr(mSaved | 0x8040); // FTZ | DAZ
+#elif ZONE_DENORMALS_ARM64
+    asm volatile("mrs %0, fpcr" : "=r"(mSaved));
+    asm volatile("msr fpcr, %0" : : "r"(mSaved | (uint64_t(1) << 24)));
+#endif
+  }
+
+  ~ScopedNoDenormals() {
+#if ZONE_DENORMALS_SSE
+    _mm_setcsr(mSaved);
+#elif ZONE_DENORMALS_ARM64
+    asm volatile("msr fpcr, %0" : : "r"(mSaved));
+#endif
+  }
+
+private:
+#if ZONE_DENORMALS_SSE
+  unsigned int mSaved = 0;
+#elif ZONE_DENORMALS_ARM64
+  uint64_t mSaved = 0;
+#endif
+};
+
+inline float flushDenormal(float x) {
+  return std::fabs(x) < 1e-15f ? 0.0f : x;
+}
+} // namespace
+
 //------------------------------------------------------------------------
 // ZoneProcessor
 //------------------------------------------------------------------------
@@ -52,6 +101,7 @@ void ZoneProcessor::clearDelayBuffers() {
   }
   reverbFilterL = 0.0f;
   reverbFilterR = 0.0f;
+  silentSamples = 0;
 }
 
 //------------------------------------------------------------------------
@@ -128,6 +178,8 @@ tresult PLUGIN_API ZoneProcessor::setActive(TBool state) {
 
 //------------------------------------------------------------------------
 tresult PLUGIN_API ZoneProcessor::process(Vst::ProcessData &data) {
+  ScopedNoDenormals noDenormals;
+
   //--- First : Read inputs parameter changes-----------
   if (data.inputParameterChanges) {
     int32 numParamsChanged = data.inputParameterChanges->getParameterCount();
@@ -184,6 +236,28 @@ tresult PLUGIN_API ZoneProcessor::process(Vst::ProcessData &data) {
     float *outR =
         (numOutChannels > 1) ? data.outputs[0].channelBuffers32[1] : outL;
 
+    // Silent input: flagged by the host, or all zeros
+    const uint64 inputMask = ((uint64)1 << numInChannels) - 1;
+    bool inputSilent = (data.inputs[0].silenceFlags & inputMask) == inputMask;
+    if (!inputSilent) {
+      inputSilent = true;
+      for (int32 i = 0; i < data.numSamples && inputSilent; ++i)
+        inputSilent = inL[i] == 0.0f && inR[i] == 0.0f;
+    }
+    silentSamples = inputSilent ? silentSamples + data.numSamples : 0;
+
+    // Once the input has been silent for longer than the tail, the chorus,
+    // shimmer and reverb have rung out: skip them and report silence. Any
+    // non-silent input wakes them on the same block.
+    if (silentSamples > tailSamples()) {
+      for (int32 c = 0; c < numOutChannels; c++) {
+        memset(data.outputs[0].channelBuffers32[c], 0,
+               data.numSamples * sizeof(float));
+      }
+      data.outputs[0].silenceFlags = ((uint64)1 << numOutChannels) - 1;
+      return kResultOk;
+    }
+
     // Constants for processing
     const float pi = 3.14159265358979323846f;
     const float chorusLfoInc =
@@ -257,10 +331,10 @@ tresult PLUGIN_API ZoneProcessor::process(Vst::ProcessData &data) {
         float shimmerCoeff = 0.95f;
         float highPassL = wetL - shimmerFilterL;
         float highPassR = wetR - shimmerFilterR;
-        shimmerFilterL =
-            shimmerFilterL * shimmerCoeff + wetL * (1.0f - shimmerCoeff);
-        shimmerFilterR =
-            shimmerFilterR * shimmerCoeff + wetR * (1.0f - shimmerCoeff);
+        shimmerFilterL = flushDenormal(shimmerFilterL * shimmerCoeff +
+                                       wetL * (1.0f - shimmerCoeff));
+        shimmerFilterR = flushDenormal(shimmerFilterR * shimmerCoeff +
+                                       wetR * (1.0f - shimmerCoeff));
 
         // Add the shimmer delay feedback
         int shimmerReadPos =
@@ -269,8 +343,10 @@ tresult PLUGIN_API ZoneProcessor::process(Vst::ProcessData &data) {
         float shimmerR = shimmerDelayR[shimmerReadPos] * 0.5f * fShimmerAmount;
 
         // Write to shimmer delay (high frequencies + feedback)
-        shimmerDelayL[shimmerWritePos] = highPassL * 0.3f + shimmerL * 0.6f;
-        shimmerDelayR[shimmerWritePos] = highPassR * 0.3f + shimmerR * 0.6f;
+        shimmerDelayL[shimmerWritePos] =
+            flushDenormal(highPassL * 0.3f + shimmerL * 0.6f);
+        shimmerDelayR[shimmerWritePos] =
+            flushDenormal(highPassR * 0.3f + shimmerR * 0.6f);
         shimmerWritePos = (shimmerWritePos + 1) % kMaxDelayLength;
 
         // Add shimmer to wet signal
@@ -300,8 +376,10 @@ tresult PLUGIN_API ZoneProcessor::process(Vst::ProcessData &data) {
 
         // Low-pass filter reverb tail
         float lpCoeff = 0.3f;
-        reverbFilterL = reverbFilterL * (1.0f - lpCoeff) + reverbL * lpCoeff;
-        reverbFilterR = reverbFilterR * (1.0f - lpCoeff) + reverbR * lpCoeff;
+        reverbFilterL = flushDenormal(reverbFilterL * (1.0f - lpCoeff) +
+                                      reverbL * lpCoeff);
+        reverbFilterR = flushDenormal(reverbFilterR * (1.0f - lpCoeff) +
+                                      reverbR * lpCoeff);
 
         // Write to delay lines with feedback (Hadamard-like mixing)
         float inputL = wetL * 0.5f + reverbFilterL * reverbFeedback;
@@ -355,6 +433,27 @@ tresult PLUGIN_API ZoneProcessor::process(Vst::ProcessData &data) {
   return kResultOk;
 }
 
+//------------------------------------------------------------------------
+int32 ZoneProcessor::tailSamples() const {
+  // Passes around a feedback loop until it has decayed by 80 dB
+  auto passes = [](float gain) {
+    return 1 + static_cast<int32>(std::ceil(std::log(1e-4f) / std::log(gain)));
+  };
+  int32 tail = kChorusDelayLength;
+  // Shimmer: a 2000-sample loop at 0.5 * amount * 0.6 per pass
+  if (fShimmerAmount > 0.001f)
+    tail += passes(0.3f * fShimmerAmount) * 2000;
+  if (fReverbMix > 0.001f)
+    tail += passes(0.6f + fReverbDecay * 0.35f) *
+            kReverbDelayTimes[kReverbDelayLines - 1];
+  return tail;
+}
+
+//------------------------------------------------------------------------
+uint32 PLUGIN_API ZoneProcessor::getTailSamples() {
+  return static_cast<uint32>(tailSamples());
+}
+
 //------------------------------------------------------------------------
 tresult PLUGIN_API ZoneProcessor::setupProcessing(Vst::ProcessSetup &newSetup) {
   //--- called before any processing ----
@@ -55,6 +55,9 @@ public:
   Steinberg::tresult PLUGIN_API process(Steinberg::Vst::ProcessData &data)
       SMTG_OVERRIDE;
 
+  /** Samples of output that follow the end of the input */
+  Steinberg::uint32 PLUGIN_API getTailSamples() SMTG_OVERRIDE;
+
   /** For persistence */
   Steinberg::tresult PLUGIN_API setState(Steinberg::IBStream *state)
       SMTG_OVERRIDE;
@@ -76,6 +79,9 @@ protected:
   // Sample rate
   double sampleRate = 44100.0;
 
+  // Consecutive silent input samples; past the tail, processing sleeps
+  Steinberg::int64 silentSamples = 0;
+
   // Chorus state
   std::vector<float> chorusDelayL;
   std::vector<float> chorusDelayR;
@@ -104,6 +110,7 @@ protected:
   void clearDelayBuffers();
   float softClip(float x, float amount);
   float processSample(float inL, float inR, float &outL, float &outR);
+  Steinberg::int32 tailSamples() const;
 };
 
 //------------------------------------------------------------------------